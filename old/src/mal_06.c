@@ -22,6 +22,8 @@ SOFTWARE.
 */
 #include <math.h>
 #include <ctype.h>
+#include <limits.h>
+#include <setjmp.h>
 #include <stdio.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -30,6 +32,34 @@ SOFTWARE.
 #define DEBUG 0
 #define GC_ON 1
 #define VAR_NIL 0
+#define ENV_LINEAR 8
+#define GC_IMMORTAL (-1)
+#define GC_WHITE 0
+#define GC_BLACK 1
+#define GC_OLD 2
+#define GC_REMEMBERED 3
+#define GC_STACK 4
+#define GC_NURSERY 4096
+#define SLAB_PAGE 65536
+#define SLAB_CLASSES 13
+#define SLAB_MAX 512
+#define VECTOR_BITS 5
+#define VECTOR_WIDTH (1 << VECTOR_BITS)
+#define VECTOR_MASK (VECTOR_WIDTH - 1)
+#define HASHMAP_BITS 5
+#define HASHMAP_MASK ((1 << HASHMAP_BITS) - 1)
+#define SMALL_INTEGER_MIN (-256)
+#define SMALL_INTEGER_MAX 1024
+#define LOCAL_BITS 16
+#define LOCAL_MASK ((1 << LOCAL_BITS) - 1)
+#define FRAMES_MAX 1000000
+#define EVAL_DEPTH_MAX 4000
+
+#if defined(__GNUC__)
+#define GC_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define GC_PREFETCH(address) ((void)(address))
+#endif
 
 typedef enum {false, true} bool;
 
@@ -43,12 +73,24 @@ struct function_s;
 typedef struct function_s function_t, *function_p;
 struct closure_s;
 typedef struct closure_s closure_t, *closure_p;
+struct lambda_s;
+typedef struct lambda_s lambda_t, *lambda_p;
+struct code_s;
+typedef struct code_s code_t, *code_p;
+struct instr_s;
+typedef struct instr_s instr_t, *instr_p;
+struct frame_s;
+typedef struct frame_s frame_t, *frame_p;
 struct list_s;
 typedef struct list_s list_t, *list_p;
 struct vector_s;
 typedef struct vector_s vector_t, *vector_p;
+struct vector_node_s;
+typedef struct vector_node_s vector_node_t, *vector_node_p;
 struct hashmap_s;
 typedef struct hashmap_s hashmap_t, *hashmap_p;
+struct hashmap_node_s;
+typedef struct hashmap_node_s hashmap_node_t, *hashmap_node_p;
 struct env_s;
 typedef struct env_s env_t, *env_p, **env_pp;
 struct error_s;
@@ -61,12 +103,39 @@ struct reader_s;
 typedef struct reader_s reader_t, *reader_p, **reader_pp;
 struct readers_s;
 typedef struct readers_s readers_t, *readers_p, **readers_pp;
+struct symbols_s;
+typedef struct symbols_s symbols_t, *symbols_p, **symbols_pp;
+struct roots_s;
+typedef struct roots_s roots_t, *roots_p;
+struct values_s;
+typedef struct values_s values_t, *values_p;
+struct frames_s;
+typedef struct frames_s frames_t, *frames_p;
+struct envs_s;
+typedef struct envs_s envs_t, *envs_p;
+struct handler_s;
+typedef struct handler_s handler_t, *handler_p;
+struct catch_s;
+typedef struct catch_s catch_t, *catch_p;
+struct catches_s;
+typedef struct catches_s catches_t, *catches_p;
+struct slab_page_s;
+typedef struct slab_page_s slab_page_t, *slab_page_p, **slab_page_pp;
+struct slab_s;
+typedef struct slab_s slab_t, *slab_p;
+struct position_s;
+typedef struct position_s position_t, *position_p;
+struct positions_s;
+typedef struct positions_s positions_t, *positions_p;
+struct scope_s;
+typedef struct scope_s scope_t, *scope_p;
 struct lvm_s;
 typedef struct lvm_s lvm_t, *lvm_p, **lvm_pp;
 
 typedef enum {
-  GC_TEXT, GC_TOKEN, GC_LIST, GC_VECTOR, GC_ENV, GC_HASHMAP, GC_MAL, GC_COMMENT,
-  GC_FUNCTION, GC_CLOSURE, GC_ERROR
+  GC_TEXT, GC_TOKEN, GC_LIST, GC_VECTOR, GC_VECTOR_NODE, GC_ENV, GC_HASHMAP,
+  GC_HASHMAP_NODE, GC_MAL, GC_COMMENT, GC_FUNCTION, GC_CLOSURE, GC_CODE,
+  GC_ERROR, GC_LAMBDA
 } gc_type;
 
 typedef enum {
@@ -92,16 +161,66 @@ struct text_s {
 
 struct function_s {
   gc_t gc;
-  mal_p (*definition)(lvm_p this, mal_p params);
+  mal_p (*definition)(lvm_p this, size_t argc, mal_pp argv);
   text_p name;
 };
 
 struct closure_s {
   gc_t gc;
   env_p env;
+  lambda_p lambda;
+};
+
+/* what one fn* form resolves to, shared by every closure made from it */
+struct lambda_s {
+  gc_t gc;
+  mal_p form;
   mal_p parameters;
   mal_p more;
   mal_p definition;
+  list_p captured;
+  list_p outside;
+  list_p defined;
+  code_p code;
+  bool flat;
+};
+
+struct instr_s {
+  void (*op)(lvm_p this, frame_p frame, instr_p instr);
+  size_t operand;
+  mal_p constant;
+  size_t version;
+};
+
+struct code_s {
+  gc_t gc;
+  instr_p data;
+  size_t count;
+  size_t capacity;
+  bool stack;
+  scope_p scope;
+  list_p defined;
+  mal_p error;
+  struct {
+    bool active;
+    bool fresh;
+    size_t start;
+    size_t count;
+    size_t depth;
+  } loop;
+};
+
+struct frame_s {
+  code_p code;
+  env_p env;
+  size_t ip;
+  size_t root;
+  size_t base;
+  size_t bottom;
+  size_t envs;
+  size_t version;
+  bool shadow;
+  mal_p result;
 };
 
 struct list_s {
@@ -109,26 +228,52 @@ struct list_s {
   mal_pp data;
   size_t count;
   size_t capacity;
+  mal_p tail;
+  list_p base;
+};
+
+struct vector_node_s {
+  gc_t gc;
+  gc_p slots[VECTOR_WIDTH];
 };
 
 struct vector_s {
   gc_t gc;
-  mal_pp data;
+  vector_node_p root;
+  mal_pp tail;
   size_t count;
+  size_t shift;
+  size_t tail_count;
   size_t capacity;
 };
 
-struct hashmap_s {
+struct hashmap_node_s {
   gc_t gc;
-  mal_pp data;
+  gc_pp data;
+  unsigned long bitmap;
   size_t count;
   size_t capacity;
+  size_t hash;
+  size_t edit;
+  bool collision;
+};
+
+struct hashmap_s {
+  gc_t gc;
+  hashmap_node_p root;
+  size_t count;
+  size_t edit;
 };
 
 struct env_s {
   gc_t gc;
   env_p outer;
-  vector_p hashmap;
+  mal_pp data;
+  size_t count;
+  size_t capacity;
+  size_t *index;
+  size_t mask;
+  bool shadow;
 };
 
 struct error_s {
@@ -185,9 +330,15 @@ struct token_s {
 typedef enum {
   MAL_EOI, MAL_ERROR, MAL_BOOLEAN, MAL_SYMBOL, MAL_KEYWORD, MAL_STRING,
   MAL_NIL, MAL_LIST, MAL_VECTOR, MAL_HASHMAP, MAL_INTEGER, MAL_DECIMAL,
-  MAL_ENV, MAL_FUNCTION, MAL_CLOSURE
+  MAL_ENV, MAL_FUNCTION, MAL_CLOSURE, MAL_LOCAL, MAL_LAMBDA
 } mal_type;
 
+typedef enum {
+  SPECIAL_NONE, SPECIAL_DEF_BANG, SPECIAL_LET_STAR, SPECIAL_IF, SPECIAL_FN_STAR,
+  SPECIAL_DO, SPECIAL_ENV, SPECIAL_TRY_STAR, SPECIAL_CATCH_STAR, SPECIAL_LOOP,
+  SPECIAL_RECUR
+} special_type;
+
 typedef union {
   text_p eoi;
   text_p error;
@@ -204,18 +355,28 @@ typedef union {
   env_p env;
   long integer;
   double decimal;
+  mal_p local;
+  lambda_p lambda;
 } mal_value;
 
 struct mal_s {
   gc_t gc;
   mal_type type;
+  special_type special;
   mal_value as;
-  token_p token;
-  text_p signature;
-  text_p identity;
   size_t hash;
 };
 
+/* symbols bound by one env frame, in slot order. while a let* or loop
+ * value is analysed, bindings holds the pairs of that form and next the
+ * pair being bound, since the names from there on are not bound yet */
+struct scope_s {
+  list_p symbols;
+  list_p bindings;
+  size_t next;
+  scope_p outer;
+};
+
 struct reader_s {
   char *str;
   size_t pos;
@@ -231,14 +392,141 @@ struct readers_s {
   size_t capacity;
 };
 
+struct symbols_s {
+  mal_pp data;
+  size_t count;
+  size_t capacity;
+};
+
+struct roots_s {
+  gc_pp data;
+  size_t count;
+  size_t capacity;
+};
+
+struct values_s {
+  mal_pp data;
+  size_t count;
+  size_t capacity;
+};
+
+struct frames_s {
+  frame_p data;
+  size_t count;
+  size_t capacity;
+  size_t max;
+  size_t depth;
+  size_t depth_max;
+};
+
+struct envs_s {
+  env_pp data;
+  size_t count;
+  size_t capacity;
+};
+
+struct handler_s {
+  jmp_buf jump;
+  size_t roots;
+  size_t values;
+  size_t frames;
+  size_t depth;
+  size_t envs;
+  size_t errors;
+  mal_p error;
+  handler_p outer;
+};
+
+/* a try* entered by compiled code, resumed at its catch* by lvm_run */
+struct catch_s {
+  frame_t frame;
+  size_t roots;
+  size_t values;
+  size_t frames;
+  size_t depth;
+  size_t envs;
+  size_t errors;
+};
+
+struct catches_s {
+  catch_p data;
+  size_t count;
+  size_t capacity;
+};
+
+struct slab_page_s {
+  slab_page_p prev;
+  slab_page_p next;
+  char *base;
+  char *bump;
+  char *end;
+  void *free;
+  size_t used;
+  size_t size;
+  size_t size_class;
+  bool listed;
+};
+
+struct slab_s {
+  slab_page_p partial[SLAB_CLASSES];
+  slab_page_pp pages;
+  size_t count;
+  size_t capacity;
+  unsigned char lookup[(SLAB_MAX >> 4) + 1];
+};
+
+struct position_s {
+  mal_p mal;
+  size_t line;
+  size_t column;
+};
+
+struct positions_s {
+  position_p data;
+  size_t count;
+  size_t capacity;
+};
+
 struct lvm_s {
   struct {
     gc_p first;
+    gc_p old;
+    gc_p immortal;
+    struct {
+      gc_pp data;
+      size_t count;
+      size_t capacity;
+    } gray;
+    struct {
+      gc_pp data;
+      size_t count;
+      size_t capacity;
+    } remembered;
     size_t count;
     size_t total;
+    size_t old_count;
+    size_t old_total;
     int mark;
+    bool major;
   } gc;
+  slab_t slab;
+  size_t edits;
+  size_t version;
+  struct {
+    mal_p eoi;
+    mal_p nil;
+    mal_p boolean[2];
+    mal_pp integer;
+  } constant;
   readers_t readers;
+  symbols_t symbols;
+  positions_t positions;
+  roots_t roots;
+  values_t values;
+  frames_t frames;
+  envs_t envs;
+  catches_t catches;
+  handler_p handler;
   env_p env;
   error_p error;
   comment_p comment;
@@ -271,42 +559,100 @@ text_p comment_append(lvm_p this, text_p text);
 text_p comment_collapse(lvm_p this);
 void comment_free(lvm_p this, gc_p gc);
 function_p function_make(lvm_p this,
-    mal_p (*definition)(lvm_p this, mal_p params), text_p name);
+    mal_p (*definition)(lvm_p this, size_t argc, mal_pp argv), text_p name);
 void function_free(lvm_p this, gc_p gc);
-closure_p closure_make(lvm_p this, env_p env, mal_p parameters,
-    mal_p definition, mal_p more);
+closure_p closure_make(lvm_p this, env_p env, lambda_p lambda);
 text_p closure_text(lvm_p this, closure_p closure);
 mal_p closure_parameters(lvm_p this, mal_pp params, mal_pp more);
+list_p closure_store(lvm_p this, list_p list, list_p copy, size_t at,
+    mal_p mal);
+mal_p closure_resolve(lvm_p this, mal_p ast, scope_p scope, list_p defined);
+void closure_defined(lvm_p this, mal_p ast, list_p defined);
+list_p closure_scope(lvm_p this, list_p parameters, mal_p more);
+bool closure_bound(lvm_p this, scope_p scope, mal_p symbol);
+bool closure_pending(lvm_p this, scope_p scope, mal_p symbol);
+bool closure_captures(lvm_p this, mal_p ast, scope_p scope, list_p outside,
+    list_p locals);
+mal_p closure_lambda(lvm_p this, mal_p ast, scope_p scope, list_p defined);
+env_p closure_env(lvm_p this, env_p env, lambda_p lambda);
+bool closure_escapes(lvm_p this, mal_p ast);
 void closure_free(lvm_p this, gc_p gc);
+lambda_p lambda_make(lvm_p this, mal_p form);
+void lambda_free(lvm_p this, gc_p gc);
+code_p code_make(lvm_p this);
+size_t code_emit(lvm_p this, code_p code,
+    void (*op)(lvm_p this, frame_p frame, instr_p instr), size_t operand,
+    mal_p constant);
+void code_patch(lvm_p this, code_p code, size_t at);
+void code_free(lvm_p this, gc_p gc);
 list_p list_make(lvm_p this, size_t init);
 bool list_append(lvm_p this, list_p list, mal_p mal);
 text_p list_text(lvm_p this, list_p list);
 text_p list_more_text(lvm_p this, list_p list, mal_p more);
+list_p list_slice(lvm_p this, list_p original, size_t offset, size_t count);
 list_p list_offset(lvm_p this, list_p original, size_t offset);
 list_p list_params(lvm_p this, list_p original);
 mal_p list_find(lvm_p this, list_p list, mal_p symbol);
 mal_p list_equal(lvm_p this, list_p list0, list_p list1);
 void list_free(lvm_p this, gc_p list);
 vector_p vector_make(lvm_p this, size_t init);
+vector_p vector_copy(lvm_p this, vector_p vector);
 bool vector_append(lvm_p this, vector_p vector, mal_p mal);
+bool vector_pop(lvm_p this, vector_p vector);
+vector_p vector_assoc(lvm_p this, vector_p vector, size_t offset, mal_p mal);
+mal_p vector_get(lvm_p this, vector_p vector, size_t offset);
+vector_node_p vector_node_make(lvm_p this, vector_node_p copy);
+vector_node_p vector_node_leaf(vector_p vector, size_t offset);
+vector_node_p vector_node_push(lvm_p this, vector_p vector, size_t level,
+    vector_node_p parent, vector_node_p leaf);
+vector_node_p vector_node_pop(lvm_p this, vector_p vector, size_t level,
+    vector_node_p node);
+vector_node_p vector_node_assoc(lvm_p this, size_t level, vector_node_p node,
+    size_t offset, mal_p mal);
+void vector_node_free(lvm_p this, gc_p node);
 mal_p vector_equal(lvm_p this, vector_p vector0, vector_p vector1);
 list_p vector_list(lvm_p this, vector_p vector);
 void vector_free(lvm_p this, gc_p vector);
 hashmap_p hashmap_make(lvm_p this, size_t init);
+hashmap_p hashmap_copy(lvm_p this, hashmap_p hashmap);
 bool hashmap_set(lvm_p this, hashmap_p hashmap, mal_p key, mal_p value);
 bool hashmap_get(lvm_p this, hashmap_p hashmap, mal_p key, mal_pp value);
-bool hashmap_get_by_text(lvm_p this, hashmap_p hashmap, text_p key,
-    mal_pp value);
-bool hashmap_append(lvm_p this, hashmap_p hashmap, mal_p mal);
-text_p hashmap_text(lvm_p this, hashmap_p hashmap);
+hashmap_p hashmap_assoc(lvm_p this, hashmap_p hashmap, mal_p key,
+    mal_p value);
+hashmap_p hashmap_dissoc(lvm_p this, hashmap_p hashmap, mal_p key);
+list_p hashmap_list(lvm_p this, hashmap_p hashmap);
 text_p hashmap_text(lvm_p this, hashmap_p hashmap);
 mal_p hashmap_equal(lvm_p this, hashmap_p hashmap0, hashmap_p hashmap1);
 void hashmap_free(lvm_p this, gc_p hashmap);
-env_p env_make(lvm_p this, env_p outer, list_p symbols, list_p exprs,
-    mal_p more, size_t init);
+size_t hashmap_popcount(unsigned long bitmap);
+hashmap_node_p hashmap_node_make(lvm_p this, size_t capacity, size_t edit);
+hashmap_node_p hashmap_node_edit(lvm_p this, hashmap_node_p node,
+    size_t capacity, size_t edit);
+hashmap_node_p hashmap_node_pair(lvm_p this, size_t shift, mal_p key0,
+    mal_p value0, size_t hash1, mal_p key1, mal_p value1, size_t edit);
+hashmap_node_p hashmap_node_assoc(lvm_p this, hashmap_node_p node,
+    size_t shift, size_t hash, mal_p key, mal_p value, size_t edit,
+    bool *added);
+hashmap_node_p hashmap_node_dissoc(lvm_p this, hashmap_node_p node,
+    size_t shift, size_t hash, mal_p key, size_t edit, bool *removed);
+void hashmap_node_put(lvm_p this, hashmap_node_p node, size_t at, gc_p gc);
+void hashmap_node_list(lvm_p this, hashmap_node_p node, list_p list);
+void hashmap_node_free(lvm_p this, gc_p node);
+env_p env_make(lvm_p this, env_p outer, list_p symbols, size_t argc,
+    mal_pp argv, mal_p more, size_t init);
+env_p env_push(lvm_p this, env_p outer, list_p symbols, size_t argc,
+    mal_pp argv, mal_p more, size_t init);
+void env_pop(lvm_p this, size_t base);
+env_p env_alloc(lvm_p this, env_p outer, size_t init);
+env_p env_bind(lvm_p this, env_p env, list_p symbols, size_t argc,
+    mal_pp argv, mal_p more);
+size_t env_find(lvm_p this, env_p env, mal_p key);
+bool env_index(lvm_p this, env_p env, size_t capacity);
 bool env_set(lvm_p this, env_p env, mal_p key, mal_p value);
 bool env_get(lvm_p this, env_p env, mal_p key, mal_pp value);
-bool env_get_by_text(lvm_p this, env_p env, text_p key, mal_pp value);
+bool env_capture(lvm_p this, env_p env, env_p capture, mal_p key);
+mal_p env_local(lvm_p this, env_p env, mal_p local);
+void env_shadow(lvm_p this, env_p env, mal_p key);
 text_p env_text(lvm_p this, env_p env);
 void env_free(lvm_p this, gc_p env);
 #if __STDC__
@@ -359,9 +705,13 @@ mal_p mal_vector(lvm_p this, vector_p vector);
 mal_p mal_hashmap(lvm_p this, hashmap_p hashmap);
 mal_p mal_integer(lvm_p this, long integer);
 mal_p mal_decimal(lvm_p this, double decimal);
-mal_p mal_as_str(lvm_p this, mal_p args, bool readable, char *separator);
+mal_p mal_local(lvm_p this, mal_p symbol, size_t depth, size_t slot);
+mal_p mal_lambda(lvm_p this, lambda_p lambda);
+mal_p mal_as_str(lvm_p this, size_t argc, mal_pp argv, bool readable,
+    char *separator);
 mal_p mal_type_of(lvm_p this, mal_p mal);
 text_p mal_print(lvm_p this, mal_p mal, bool readable);
+text_p mal_display_position(lvm_p this, mal_p mal, char *text);
 void mal_free(lvm_p this, gc_p mal);
 bool is_eoi(mal_p mal);
 bool is_nil(mal_p mal);
@@ -372,6 +722,8 @@ bool is_integer(mal_p mal);
 bool is_decimal(mal_p mal);
 bool is_number(mal_p mal);
 bool is_symbol(mal_p mal);
+bool is_local(mal_p mal);
+bool is_lambda(mal_p mal);
 bool is_keyword(mal_p mal);
 bool is_string(mal_p mal);
 bool is_self_evaluating(mal_p mal);
@@ -382,14 +734,57 @@ bool is_env(mal_p mal);
 bool is_sequential(mal_p mal);
 bool is_function(mal_p mal);
 bool is_callable(mal_p mal);
+bool is_interned(mal_p mal);
+bool mal_key_equal(lvm_p this, mal_p key0, mal_p key1);
+size_t mal_hash(lvm_p this, mal_p mal);
 bool readers_push(lvm_p this, reader_p reader);
 bool readers_pop(lvm_p this);
 reader_p readers_get(lvm_p this);
+mal_pp symbols_find(lvm_p this, mal_type type, text_p name, size_t hash);
+mal_p symbols_intern(lvm_p this, mal_type type, text_p name);
+bool symbols_grow(lvm_p this);
+void symbols_free(lvm_p this);
+void slab_init(lvm_p this);
+void *slab_alloc(lvm_p this, size_t size);
+void *slab_realloc(lvm_p this, void *ptr, size_t old, size_t size);
+void slab_free(lvm_p this, void *ptr, size_t size);
+slab_page_p slab_page_make(lvm_p this, size_t size_class);
+slab_page_p slab_page_find(lvm_p this, void *ptr);
+void slab_page_free(lvm_p this, slab_page_p page);
+void slab_destroy(lvm_p this);
+size_t roots_push(lvm_p this, gc_p gc);
+void roots_set(lvm_p this, size_t slot, gc_p gc);
+void roots_pop(lvm_p this, size_t base);
+void roots_free(lvm_p this);
+bool values_push(lvm_p this, mal_p mal);
+void values_pop(lvm_p this, size_t base);
+void values_free(lvm_p this);
+bool frames_push(lvm_p this, frame_p frame);
+void frames_free(lvm_p this);
+void envs_free(lvm_p this);
+bool catches_push(lvm_p this, catch_p record);
+void catches_free(lvm_p this);
+position_p positions_find(lvm_p this, mal_p mal);
+mal_p positions_set(lvm_p this, mal_p mal, token_p token);
+position_p positions_get(lvm_p this, mal_p mal);
+bool positions_rebuild(lvm_p this, size_t capacity, bool purge);
+void positions_free(lvm_p this);
 lvm_p lvm_make();
+void lvm_immortal(lvm_p this, gc_p gc);
+void lvm_immortal_mark(lvm_p this, gc_p gc);
+void lvm_immortal_pin(lvm_p this);
+bool lvm_gc_unmarked(lvm_p this, gc_p gc);
+void lvm_gc_barrier(lvm_p this, gc_p container, gc_p value);
+void lvm_gc_mark(lvm_p this, gc_p gc);
+void lvm_gc_drain(lvm_p this);
+void lvm_gc_gray(lvm_p this, gc_p gc);
+void lvm_gc_scan(lvm_p this, gc_p gc);
+void lvm_gc_release(lvm_p this, gc_p gc);
 void lvm_gc(lvm_p this);
 void lvm_gc_free(lvm_p this);
 void lvm_free(lvm_pp this);
 mal_p eval_ast(lvm_p this, mal_p ast, env_p env);
+mal_p eval_loop(lvm_p this, mal_p ast, env_p env, size_t root);
 mal_p eval_list(lvm_p this, list_p original, env_p env);
 mal_p eval_vector(lvm_p this, vector_p original, env_p env);
 mal_p eval_hashmap(lvm_p this, hashmap_p original, env_p env);
@@ -398,49 +793,108 @@ mal_p eval_let_star(lvm_p this, mal_p ast, env_pp outer);
 mal_p eval_if(lvm_p this, mal_p ast, env_pp env);
 mal_p eval_fn_star(lvm_p this, mal_p ast, env_p env);
 mal_p eval_do(lvm_p this, mal_p ast, env_p env);
-mal_p core_add(lvm_p this, mal_p args);
-mal_p core_sub(lvm_p this, mal_p args);
-mal_p core_mul(lvm_p this, mal_p args);
-mal_p core_div(lvm_p this, mal_p args);
-mal_p core_eq(lvm_p this, mal_p args);
-mal_p core_lt(lvm_p this, mal_p args);
-mal_p core_le(lvm_p this, mal_p args);
-mal_p core_gt(lvm_p this, mal_p args);
-mal_p core_ge(lvm_p this, mal_p args);
-mal_p core_list(lvm_p this, mal_p args);
-mal_p core_vector(lvm_p this, mal_p args);
-mal_p core_hashmap(lvm_p this, mal_p args);
-mal_p core_zip(lvm_p this, mal_p args);
-mal_p core_listp(lvm_p this, mal_p args);
-mal_p core_vectorp(lvm_p this, mal_p args);
-mal_p core_hashmapp(lvm_p this, mal_p args);
-mal_p core_envp(lvm_p this, mal_p args);
-mal_p core_emptyp(lvm_p this, mal_p args);
-mal_p core_count(lvm_p this, mal_p args);
-mal_p core_pr_str(lvm_p this, mal_p args);
-mal_p core_str(lvm_p this, mal_p args);
-mal_p core_prn(lvm_p this, mal_p args);
-mal_p core_println(lvm_p this, mal_p args);
-mal_p core_type(lvm_p this, mal_p args);
+mal_p eval_try_star(lvm_p this, mal_p ast, env_p env);
+mal_p eval_loop_form(lvm_p this, mal_p ast, env_p env);
+mal_p eval_recur_form(lvm_p this, mal_p ast, env_p env);
+mal_p eval_form(lvm_p this, mal_p ast, env_p env);
+mal_p eval_apply(lvm_p this, mal_p callable, size_t argc, mal_pp argv,
+    env_p env);
+code_p compile(lvm_p this, mal_p ast);
+void compile_form(lvm_p this, code_p code, mal_p ast, bool tail);
+void compile_value(lvm_p this, code_p code, mal_p ast);
+bool compile_def_bang(lvm_p this, code_p code, mal_p ast, bool tail);
+void compile_fn_star(lvm_p this, code_p code, mal_p ast);
+void compile_scope(lvm_p this, code_p code, scope_p scope, mal_p ast,
+    list_p bindings);
+bool compile_let_star(lvm_p this, code_p code, mal_p ast, bool tail);
+bool compile_if(lvm_p this, code_p code, mal_p ast, bool tail);
+void compile_do(lvm_p this, code_p code, mal_p ast, bool tail);
+bool compile_try_star(lvm_p this, code_p code, mal_p ast, bool tail);
+list_p compile_loop_bindings(lvm_p this, mal_p ast);
+bool compile_loop(lvm_p this, code_p code, mal_p ast, bool tail);
+bool compile_recur(lvm_p this, code_p code, mal_p ast);
+void compile_call(lvm_p this, code_p code, mal_p ast, bool tail);
+void compile_vector(lvm_p this, code_p code, mal_p ast);
+void compile_hashmap(lvm_p this, code_p code, mal_p ast);
+bool integer_add(long a, long b, long *result);
+bool integer_sub(long a, long b, long *result);
+bool integer_mul(long a, long b, long *result);
+mal_p integer_overflow(lvm_p this, char *operator);
+mal_p core_add(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_sub(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_mul(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_div(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_eq(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_lt(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_le(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_gt(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_ge(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_list(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_vector(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_hashmap(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_zip(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_listp(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_vectorp(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_hashmapp(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_envp(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_emptyp(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_count(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_assoc(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_dissoc(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_pop(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_pr_str(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_str(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_prn(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_println(lvm_p this, size_t argc, mal_pp argv);
+mal_p core_type(lvm_p this, size_t argc, mal_pp argv);
 mal_p lvm_read(lvm_p this, char *str);
 mal_p lvm_eval(lvm_p this, mal_p ast, env_p env);
+mal_p lvm_run(lvm_p this, code_p code, env_p env);
+mal_p lvm_try(lvm_p this, handler_p handler, mal_p ast, env_p env);
+void lvm_raise(lvm_p this, mal_p error);
+void op_push(lvm_p this, frame_p frame, mal_p value);
+void op_constant(lvm_p this, frame_p frame, instr_p instr);
+void op_symbol(lvm_p this, frame_p frame, instr_p instr);
+void op_local(lvm_p this, frame_p frame, instr_p instr);
+void op_eval(lvm_p this, frame_p frame, instr_p instr);
+void op_closure(lvm_p this, frame_p frame, instr_p instr);
+void op_env(lvm_p this, frame_p frame, instr_p instr);
+void op_vector(lvm_p this, frame_p frame, instr_p instr);
+void op_try(lvm_p this, frame_p frame, instr_p instr);
+void op_untry(lvm_p this, frame_p frame, instr_p instr);
+void op_catch(lvm_p this, frame_p frame, mal_p error, size_t catches);
+void op_hashmap(lvm_p this, frame_p frame, instr_p instr);
+void op_def(lvm_p this, frame_p frame, instr_p instr);
+void op_let(lvm_p this, frame_p frame, instr_p instr);
+void op_let_stack(lvm_p this, frame_p frame, instr_p instr);
+void op_bind(lvm_p this, frame_p frame, instr_p instr);
+void op_unlet(lvm_p this, frame_p frame, instr_p instr);
+void op_pop(lvm_p this, frame_p frame, instr_p instr);
+void op_jump(lvm_p this, frame_p frame, instr_p instr);
+void op_jump_false(lvm_p this, frame_p frame, instr_p instr);
+void op_return(lvm_p this, frame_p frame, instr_p instr);
+void op_recur(lvm_p this, frame_p frame, instr_p instr);
+void op_recur_fresh(lvm_p this, frame_p frame, instr_p instr);
+mal_p op_invoke(lvm_p this, frame_p frame, instr_p instr, bool tail);
+void op_call(lvm_p this, frame_p frame, instr_p instr);
+void op_tail_call(lvm_p this, frame_p frame, instr_p instr);
 char *lvm_print(lvm_p this, mal_p value);
 char *lvm_rep(lvm_p this, char *str);
 
 text_p text_make(lvm_p this, char *str)
 {
   size_t size = strlen(str);
-  text_p text = (text_p)calloc(1, sizeof(text_t));
+  text_p text = (text_p)slab_alloc(this, sizeof(text_t));
   text->count = size;
   text->capacity = ((0 != (size % 32)) + (size / 32)) * 32;
-  text->data = (char *)calloc((text->capacity + 1), sizeof(char));
+  text->data = (char *)slab_alloc(this, (text->capacity + 1) * sizeof(char));
   strncpy(text->data, str, size);
   text->data[size] = 0x00;
   text->gc.type = GC_TEXT;
 #if GC_ON
-  text->gc.mark = !this->gc.mark;
+  text->gc.mark = GC_WHITE;
 #else
-  text->gc.mark = this->gc.mark;
+  text->gc.mark = GC_IMMORTAL;
 #endif
   text->gc.next = this->gc.first;
   this->gc.first = (gc_p)text;
@@ -450,11 +904,16 @@ text_p text_make(lvm_p this, char *str)
 
 text_p text_append(lvm_p this, text_p text, char item)
 {
-  (void)this;
   if (text->count + 1 >= text->capacity) {
-    text->capacity = text->capacity + 32;
-    text->data = (char *)realloc(text->data, (text->capacity + 1) *
-        sizeof(char));
+    size_t capacity = text->capacity + 32;
+    char *tmp = (char *)slab_realloc(this, text->data,
+        (text->capacity + 1) * sizeof(char), (capacity + 1) * sizeof(char));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_make(this, "not enough memory"));
+      return text;
+    }
+    text->data = tmp;
+    text->capacity = capacity;
   }
   text->data[text->count] = item;
   if (item) {
@@ -466,12 +925,17 @@ text_p text_append(lvm_p this, text_p text, char item)
 text_p text_concat(lvm_p this, text_p text, char *item)
 {
   size_t size = strlen(item);
-  (void)this;
   if (text->count + size + 1 >= text->capacity) {
-    text->capacity = ((0 != ((text->count + size) % 32))
+    size_t capacity = ((0 != ((text->count + size) % 32))
         + ((text->count + size) / 32)) * 32;
-    text->data = (char *)realloc(text->data,
-        (text->capacity + 1) * sizeof(char));
+    char *tmp = (char *)slab_realloc(this, text->data,
+        (text->capacity + 1) * sizeof(char), (capacity + 1) * sizeof(char));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_make(this, "not enough memory"));
+      return text;
+    }
+    text->data = tmp;
+    text->capacity = capacity;
   }
   if (size > 0) {
     strncpy(text->data + text->count, item, size);
@@ -484,12 +948,17 @@ text_p text_concat(lvm_p this, text_p text, char *item)
 text_p text_concat_text(lvm_p this, text_p text, text_p item)
 {
   size_t size = item->count;
-  (void)this;
   if (text->count + size + 1 >= text->capacity) {
-    text->capacity = ((0 != ((text->count + size) % 32))
+    size_t capacity = ((0 != ((text->count + size) % 32))
         + ((text->count + size) / 32)) * 32;
-    text->data = (char *)realloc(text->data,
-        (text->capacity + 1) * sizeof(char));
+    char *tmp = (char *)slab_realloc(this, text->data,
+        (text->capacity + 1) * sizeof(char), (capacity + 1) * sizeof(char));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_make(this, "not enough memory"));
+      return text;
+    }
+    text->data = tmp;
+    text->capacity = capacity;
   }
   if (size > 0) {
     strncpy(text->data + text->count, item->data, size);
@@ -773,9 +1242,9 @@ char text_get(lvm_p this, text_p text, size_t offset)
 
 void text_free(lvm_p this, gc_p text)
 {
-  (void)this;
-  free((void *)((text_p)text)->data);
-  free((void *)((text_p)text));
+  slab_free(this, (void *)((text_p)text)->data,
+      (((text_p)text)->capacity + 1) * sizeof(char));
+  slab_free(this, (void *)text, sizeof(text_t));
 }
 
 bool error_make(lvm_p this)
@@ -788,9 +1257,9 @@ bool error_make(lvm_p this)
       sizeof (error_type));
   this->error->gc.type = GC_ERROR;
 #if GC_ON
-  this->error->gc.mark = !this->gc.mark;
+  this->error->gc.mark = GC_WHITE;
 #else
-  this->error->gc.mark = this->gc.mark;
+  this->error->gc.mark = GC_IMMORTAL;
 #endif
   this->error->gc.next = this->gc.first;
   this->gc.first = (gc_p)this->error;
@@ -806,9 +1275,9 @@ text_p error_append(lvm_p this, error_type type, text_p text)
     this->error->capacity = 0;
     this->error->gc.type = GC_ERROR;
 #if GC_ON
-    this->error->gc.mark = !this->gc.mark;
+    this->error->gc.mark = GC_WHITE;
 #else
-    this->error->gc.mark = this->gc.mark;
+    this->error->gc.mark = GC_IMMORTAL;
 #endif
     this->error->gc.next = this->gc.first;
     this->gc.first = (gc_p)this->error;
@@ -821,6 +1290,7 @@ text_p error_append(lvm_p this, error_type type, text_p text)
     this->error->type = (error_type *)realloc(this->error->type,
         (this->error->capacity) * sizeof (error_type));
   }
+  lvm_gc_barrier(this, (gc_p)this->error, (gc_p)text);
   this->error->type[this->error->count] = type;
   this->error->data[this->error->count++] = text;
   return text;
@@ -881,9 +1351,9 @@ bool comment_make(lvm_p this)
       (this->comment->capacity) * sizeof (text_p));
   this->comment->gc.type = GC_COMMENT;
 #if GC_ON
-  this->comment->gc.mark = !this->gc.mark;
+  this->comment->gc.mark = GC_WHITE;
 #else
-  this->comment->gc.mark = this->gc.mark;
+  this->comment->gc.mark = GC_IMMORTAL;
 #endif
   this->comment->gc.next = this->gc.first;
   this->gc.first = (gc_p)this->comment;
@@ -894,15 +1364,14 @@ bool comment_make(lvm_p this)
 text_p comment_append(lvm_p this, text_p text)
 {
   if (!this->comment) {
-    this->comment = (comment_p)calloc(1, sizeof(comment_t));
-    this->comment->count = 0;
-    this->comment->capacity = 0;
+    comment_make(this);
   }
   if (this->comment->count + 1 >= this->comment->capacity) {
     this->comment->capacity += 32;
     this->comment->data = (text_pp)realloc(this->comment->data,
         (this->comment->capacity) * sizeof (text_p));
   }
+  lvm_gc_barrier(this, (gc_p)this->comment, (gc_p)text);
   this->comment->data[this->comment->count++] = text;
   this->comment->data[this->comment->count] = NULL;
   return text;
@@ -930,16 +1399,16 @@ void comment_free(lvm_p this, gc_p gc)
 }
 
 function_p function_make(lvm_p this,
-    mal_p (*definition)(lvm_p this, mal_p params), text_p name)
+    mal_p (*definition)(lvm_p this, size_t argc, mal_pp argv), text_p name)
 {
-  function_p function = (function_p)calloc(1, sizeof(function_t));
+  function_p function = (function_p)slab_alloc(this, sizeof(function_t));
   function->definition = definition;
   function->name = name;
   function->gc.type = GC_FUNCTION;
 #if GC_ON
-  function->gc.mark = !this->gc.mark;
+  function->gc.mark = GC_WHITE;
 #else
-  function->gc.mark = this->gc.mark;
+  function->gc.mark = GC_IMMORTAL;
 #endif
   function->gc.next = this->gc.first;
   this->gc.first = (gc_p)function;
@@ -949,23 +1418,19 @@ function_p function_make(lvm_p this,
 
 void function_free(lvm_p this, gc_p gc)
 {
-  (void)this;
-  free((void *)gc);
+  slab_free(this, (void *)gc, sizeof(function_t));
 }
 
-closure_p closure_make(lvm_p this, env_p env, mal_p parameters,
-    mal_p definition, mal_p more)
+closure_p closure_make(lvm_p this, env_p env, lambda_p lambda)
 {
-  closure_p closure = (closure_p)calloc(1, sizeof(closure_t));
+  closure_p closure = (closure_p)slab_alloc(this, sizeof(closure_t));
   closure->env = env;
-  closure->parameters = parameters;
-  closure->definition = definition;
-  closure->more = more;
+  closure->lambda = lambda;
   closure->gc.type = GC_CLOSURE;
 #if GC_ON
-  closure->gc.mark = !this->gc.mark;
+  closure->gc.mark = GC_WHITE;
 #else
-  closure->gc.mark = this->gc.mark;
+  closure->gc.mark = GC_IMMORTAL;
 #endif
   closure->gc.next = this->gc.first;
   this->gc.first = (gc_p)closure;
@@ -976,10 +1441,11 @@ closure_p closure_make(lvm_p this, env_p env, mal_p parameters,
 text_p closure_text(lvm_p this, closure_p closure)
 {
   text_p mal = text_make(this, "(fn* ");
-  text_concat_text(this, mal, list_more_text(this, closure->parameters->as.list,
-      closure->more));
+  text_concat_text(this, mal, list_more_text(this,
+      closure->lambda->parameters->as.list, closure->lambda->more));
   text_append(this, mal, ' ');
-  text_concat_text(this, mal, mal_print(this, closure->definition, false));
+  text_concat_text(this, mal, mal_print(this, closure->lambda->definition,
+      false));
   return text_append(this, mal, ')');
 }
 
@@ -988,9 +1454,9 @@ mal_p closure_parameters(lvm_p this, mal_pp params, mal_pp more)
   mal_p nil;
   list_p list = is_list((*params)) ? (*params)->as.list : is_vector((*params)) ?
     vector_list(this, (*params)->as.vector) : list_make(this, 0);
-  list_p args = list_make(this, list->count - 1);
+  list_p args = list_make(this, list->count);
   size_t at;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
+  nil = mal_nil(this);
   (*more) = nil;
   if (is_vector(*params)) {
     (*params) = mal_list(this, vector_list(this, (*params)->as.vector));
@@ -998,7 +1464,6 @@ mal_p closure_parameters(lvm_p this, mal_pp params, mal_pp more)
   if (!is_list(*params) && is_symbol(*params)) {
     args = list_make(this, 1);
     list_append(this, args, (*params));
-    list_append(this, args, nil);
     (*params) = mal_list(this, args);
     return nil;
   } else if (!is_list(*params) && !is_symbol(*params)) {
@@ -1007,7 +1472,7 @@ mal_p closure_parameters(lvm_p this, mal_pp params, mal_pp more)
         "'fn*': non-symbol in argument list '"),
         mal_print(this, *params, false)), "'\n"));
   }
-  for (at = 0; at < list->count - 1; at++) {
+  for (at = 0; at < list->count; at++) {
     mal_p mal = list->data[at];
     if (!is_symbol(mal)) {
       return mal_error(this, ERROR_RUNTIME, text_concat(this,
@@ -1017,11 +1482,11 @@ mal_p closure_parameters(lvm_p this, mal_pp params, mal_pp more)
     }
     if ('&' == mal->as.symbol->data[0]) {
       if (0x00 == mal->as.symbol->data[1]) {
-        if (is_nil(list->data[at + 1])) {
+        if (at + 1 == list->count) {
           return mal_error(this, ERROR_RUNTIME, text_make(this,
               "'fn*': missing symbol after '&' in argument list\n"));
         } else if (is_symbol(list->data[at + 1]) &&
-            is_nil(list->data[at + 2]) && (at + 3) == list->count) {
+            (at + 2) == list->count) {
           if (NULL != list_find(this, args, mal)) {
             return mal_error(this, ERROR_RUNTIME, text_concat(this,
                 text_concat_text(this, text_make(this,
@@ -1031,8 +1496,7 @@ mal_p closure_parameters(lvm_p this, mal_pp params, mal_pp more)
             (*more) = list->data[at + 1];
             break;
           }
-        } else if (is_symbol(list->data[at + 1]) &&
-            !is_nil(list->data[at + 2])) {
+        } else if (is_symbol(list->data[at + 1])) {
           return mal_error(this, ERROR_RUNTIME, text_concat(this,
               text_concat_text(this, text_concat(this, text_concat_text(this,
               text_make(this, "'fn*': unexpected symbol after'& "),
@@ -1041,7 +1505,7 @@ mal_p closure_parameters(lvm_p this, mal_pp params, mal_pp more)
               "'\n"));
         }
       } else {
-        if (is_nil(list->data[at + 1]) && (at + 2) == list->count) {
+        if ((at + 1) == list->count) {
           (*more) = mal_symbol(this, text_offset(this, mal->as.symbol, 1));
         } else {
           return mal_error(this, ERROR_RUNTIME, text_concat(this,
@@ -1063,196 +1527,629 @@ mal_p closure_parameters(lvm_p this, mal_pp params, mal_pp more)
       }
     }
   }
-  list_append(this, args, nil);
   (*params) = mal_list(this, args);
   return nil;
 }
 
-void closure_free(lvm_p this, gc_p gc)
-{
-  (void)this;
-  free((void *)gc);
-}
-
-list_p list_make(lvm_p this, size_t init)
-{
-  list_p list = (list_p)calloc(1, sizeof(list_t));
-  size_t capacity = 2;
-  if (0 == init) {
-    init = 2;
-  }
-  while (capacity < init) {
-    capacity = (capacity << 1);
-  }
-  list->count = 0;
-  list->capacity = capacity;
-  list->data = (mal_pp)calloc(capacity, sizeof(mal_p));
-  list->gc.type = GC_LIST;
-#if GC_ON
-  list->gc.mark = !this->gc.mark;
-#else
-  list->gc.mark = this->gc.mark;
-#endif
-  list->gc.next = this->gc.first;
-  this->gc.first = (gc_p)list;
-  this->gc.count++;
-  return list;
-}
-
-bool list_append(lvm_p this, list_p list, mal_p mal)
+/* stores a resolved item of list, at count for its tail, into copy. the
+ * copy is made on the first item that changes, so that the form the
+ * reader made is left as it is; returns NULL while nothing changed */
+list_p closure_store(lvm_p this, list_p list, list_p copy, size_t at,
+    mal_p mal)
 {
-  (void)this;
-  if (list->count >= list->capacity) {
-    mal_pp tmp;
-    list->capacity <<= 1;
-    tmp = (mal_pp)realloc(list->data, list->capacity * sizeof(mal_p));
-    if (NULL == tmp) {
-      error_append(this, ERROR_RUNTIME, text_display_position(this,
-          reader_peek(this), "not enough memory"));
-      return false;
+  size_t in;
+  if (NULL == copy) {
+    if (mal == (at < list->count ? list->data[at] : list->tail)) {
+      return NULL;
     }
-    list->data = tmp;
+    copy = list_make(this, list->count);
+    for (in = 0; in < list->count; in++) {
+      list_append(this, copy, list->data[in]);
+    }
+    copy->tail = list->tail;
   }
-  list->data[list->count++] = mal;
-  return true;
+  if (at < list->count) {
+    copy->data[at] = mal;
+  } else {
+    copy->tail = mal;
+  }
+  return copy;
 }
 
-text_p list_text(lvm_p this, list_p list)
+/* rewrites references to the parameters and let* bindings of the body
+ * into locals addressed by frame depth and slot; symbols bound by def!
+ * anywhere in the body stay dynamic, since def! can shadow them at run
+ * time. a nested fn* sees the enclosing locals it reads through its own
+ * flat capture frame, placed right outside its parameters. returns ast
+ * when nothing in it changes, a resolved copy otherwise */
+mal_p closure_resolve(lvm_p this, mal_p ast, scope_p scope, list_p defined)
 {
-  text_p mal = text_make(this, "(");
+  list_p list;
+  list_p copy = NULL;
+  list_p bindings;
+  list_p resolved;
+  vector_p vector;
+  hashmap_p hashmap;
+  scope_t inner;
+  mal_p head;
+  mal_p mal;
+  size_t errors;
+  size_t depth;
+  size_t slot;
   size_t at = 0;
-  if (list->count > 0) {
-    text_concat_text(this, mal, mal_print(this, list->data[0], false));
-    for (at = 1; at < list->count - 1; at++) {
-      text_append(this, mal, ' ');
-      text_concat_text(this, mal, mal_print(this, list->data[at], false));
+  switch (ast->type) {
+  case MAL_SYMBOL:
+    if (SPECIAL_NONE != ast->special || list_find(this, defined, ast)) {
+      return ast;
+    }
+    for (depth = 0; scope; depth++, scope = scope->outer) {
+      for (slot = 0; slot < scope->symbols->count; slot++) {
+        if (ast == scope->symbols->data[slot]) {
+          if (depth > LOCAL_MASK || slot > LOCAL_MASK) {
+            return ast;
+          }
+          return mal_local(this, ast, depth, slot);
+        }
+      }
     }
-    if (1 != at && text_cmp(this, mal_print(this, list->data[at],
-        false), "nil")) {
-      text_concat(this, mal, " : ");
-      text_concat_text(this, mal, mal_print(this, list->data[at], false));
+    return ast;
+  case MAL_VECTOR:
+    list = vector_list(this, ast->as.vector);
+    for (at = 0; at < list->count; at++) {
+      copy = closure_store(this, list, copy, at,
+          closure_resolve(this, list->data[at], scope, defined));
     }
-  }
-  return text_append(this, mal, ')');
-}
-
-text_p list_more_text(lvm_p this, list_p list, mal_p more)
-{
-  text_p mal = text_make(this, "(");
-  size_t at = 0;
-  if (list->count > 0) {
-    text_concat_text(this, mal, mal_print(this, list->data[0], false));
-    for (at = 1; at < list->count - 1; at++) {
-      text_append(this, mal, ' ');
-      text_concat_text(this, mal, mal_print(this, list->data[at], false));
+    if (NULL == copy) {
+      return ast;
     }
-    if (!is_nil(list->data[at])) {
-      text_append(this, mal, ' ');
-      text_concat_text(this, mal, mal_print(this, list->data[at], false));
+    vector = vector_make(this, copy->count);
+    for (at = 0; at < copy->count; at++) {
+      vector_append(this, vector, copy->data[at]);
     }
+    return mal_vector(this, vector);
+  case MAL_HASHMAP:
+    /* keys are not evaluated, only the values are resolved */
+    list = hashmap_list(this, ast->as.hashmap);
+    for (at = 1; at < list->count; at += 2) {
+      copy = closure_store(this, list, copy, at,
+          closure_resolve(this, list->data[at], scope, defined));
+    }
+    if (NULL == copy) {
+      return ast;
+    }
+    hashmap = hashmap_make(this, copy->count >> 1);
+    for (at = 0; at + 1 < copy->count; at += 2) {
+      hashmap_set(this, hashmap, copy->data[at], copy->data[at + 1]);
+    }
+    return mal_hashmap(this, hashmap);
+  case MAL_LIST:
+    list = ast->as.list;
+    if (0 == list->count || list->base) {
+      return ast;
+    }
+    head = list->data[0];
+    switch (is_symbol(head) ? head->special : SPECIAL_NONE) {
+    case SPECIAL_DEF_BANG:
+      at = 2;
+      break;
+    case SPECIAL_LET_STAR:
+    case SPECIAL_LOOP:
+      if (list->count < 3 || !is_sequential(list->data[1])) {
+        return ast;
+      }
+      /* every binding is in scope from the first value on, so a fn*
+       * there sees the names bound after it in this frame and not in an
+       * outer one; a read before the slot is filled falls back to a
+       * lookup */
+      bindings = is_vector(list->data[1]) ?
+          vector_list(this, list->data[1]->as.vector) :
+          list->data[1]->as.list;
+      inner.symbols = list_make(this, 0);
+      inner.bindings = bindings;
+      inner.outer = scope;
+      for (at = 0; at + 1 < bindings->count; at += 2) {
+        if (!list_find(this, inner.symbols, bindings->data[at])) {
+          list_append(this, inner.symbols, bindings->data[at]);
+        }
+      }
+      resolved = NULL;
+      for (at = 0; at + 1 < bindings->count; at += 2) {
+        inner.next = at;
+        resolved = closure_store(this, bindings, resolved, at + 1,
+            closure_resolve(this, bindings->data[at + 1], &inner, defined));
+      }
+      inner.bindings = NULL;
+      if (resolved && is_vector(list->data[1])) {
+        vector = vector_make(this, resolved->count);
+        for (at = 0; at < resolved->count; at++) {
+          vector_append(this, vector, resolved->data[at]);
+        }
+        copy = closure_store(this, list, copy, 1, mal_vector(this, vector));
+      } else if (resolved) {
+        copy = closure_store(this, list, copy, 1, mal_list(this, resolved));
+      }
+      copy = closure_store(this, list, copy, 2,
+          closure_resolve(this, list->data[2], &inner, defined));
+      return copy ? mal_list(this, copy) : ast;
+    case SPECIAL_FN_STAR:
+      /* a malformed fn* reports its error when it is evaluated */
+      errors = this->error ? this->error->count : 0;
+      mal = closure_lambda(this, ast, scope, defined);
+      if (is_error(mal)) {
+        this->error->count = errors;
+        return ast;
+      }
+      return mal;
+    case SPECIAL_CATCH_STAR:
+      if (list->count < 3 || !is_symbol(list->data[1])) {
+        return ast;
+      }
+      inner.symbols = list_make(this, 0);
+      list_append(this, inner.symbols, list->data[1]);
+      inner.bindings = NULL;
+      inner.outer = scope;
+      copy = closure_store(this, list, copy, 2,
+          closure_resolve(this, list->data[2], &inner, defined));
+      return copy ? mal_list(this, copy) : ast;
+    case SPECIAL_NONE:
+      break;
+    default:
+      at = 1;
+      break;
+    }
+    for (; at < list->count; at++) {
+      copy = closure_store(this, list, copy, at,
+          closure_resolve(this, list->data[at], scope, defined));
+    }
+    if (list->tail) {
+      copy = closure_store(this, list, copy, list->count,
+          closure_resolve(this, list->tail, scope, defined));
+    }
+    return copy ? mal_list(this, copy) : ast;
+  default:
+    return ast;
   }
-  if (!is_nil(more)) {
-    text_concat(this, mal, " & ");
-    text_concat_text(this, mal, mal_print(this, more, false));
-  }
-  return text_append(this, mal, ')');
 }
 
-list_p list_offset(lvm_p this, list_p original, size_t offset)
+void closure_defined(lvm_p this, mal_p ast, list_p defined)
 {
-  list_p offseted = list_make(this,
-      ((long)original->count - offset) < original->count ?
-      (original->count - offset) : 0);
   size_t at;
-  mal_p mal;
-
-  for (at = offset; at < original->count; at++) {
-    list_append(this, offseted, original->data[at]);
+  if (is_lambda(ast)) {
+    ast = ast->as.lambda->form;
   }
-  if (0 == offseted->count) {
-    env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
-    list_append(this, offseted, mal);
+  if (!is_list(ast) || 0 == ast->as.list->count) {
+    return;
   }
-  return offseted;
-}
-
-list_p list_params(lvm_p this, list_p original)
-{
-  list_p params = list_make(this,
-      ((long)original->count - 1) >= 0 ? (original->count - 1) : 0);
-  size_t at;
-  mal_p mal;
-
-  for (at = 1; at < original->count; at++) {
-    list_append(this, params, original->data[at]);
+  if (SPECIAL_DEF_BANG == ast->as.list->data[0]->special &&
+      1 < ast->as.list->count && is_symbol(ast->as.list->data[1])) {
+    list_append(this, defined, ast->as.list->data[1]);
   }
-  if (0 == params->count) {
-    env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
-    list_append(this, params, mal);
+  for (at = 0; at < ast->as.list->count; at++) {
+    closure_defined(this, ast->as.list->data[at], defined);
   }
-  return params;
 }
 
-mal_p list_get(lvm_p this, list_p list, size_t offset)
+/* env_make binds the parameters first and the more symbol after them */
+list_p closure_scope(lvm_p this, list_p parameters, mal_p more)
 {
-  (void)this;
-  if (offset < list->count) {
-    return list->data[offset];
-  } else {
-    mal_p nil;
-    env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-    return nil;
+  list_p symbols = list_make(this, parameters->count + 1);
+  size_t at;
+  for (at = 0; at < parameters->count; at++) {
+    list_append(this, symbols, parameters->data[at]);
+  }
+  if (!is_nil(more) && !list_find(this, symbols, more)) {
+    list_append(this, symbols, more);
   }
+  return symbols;
 }
 
-mal_p list_find(lvm_p this, list_p list, mal_p symbol)
+bool closure_bound(lvm_p this, scope_p scope, mal_p symbol)
 {
-  mal_p result = NULL;
-  text_p text = symbol->as.symbol;
-  size_t at;
-  for (at = 0; at < list->count; at++) {
-    if (0 == text_cmp_text(this, text, list->data[at]->as.symbol)) {
-      result = list->data[at];
-      return result;
+  for (; scope; scope = scope->outer) {
+    if (list_find(this, scope->symbols, symbol)) {
+      return true;
     }
   }
-  return result;
+  return false;
 }
 
-mal_p list_equal(lvm_p this, list_p list0, list_p list1)
+/* whether the nearest frame binding symbol has yet to bind it, so that
+ * a copy taken now would miss the value */
+bool closure_pending(lvm_p this, scope_p scope, mal_p symbol)
 {
-  mal_p t;
-  mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if (list0->count != list1->count) {
-    return f;
-  } else {
-    size_t at;
-    for (at = 0; at < list0->count; at++) {
-      list_p args = list_make(this, 0);
-      mal_p cmp;
-      list_append(this, args, list0->data[at]);
-      list_append(this, args, list1->data[at]);
-      cmp = core_eq(this, mal_list(this, args));
-      if (is_false(cmp)) {
-        return f;
+  size_t at;
+  for (; scope; scope = scope->outer) {
+    if (list_find(this, scope->symbols, symbol)) {
+      if (NULL == scope->bindings) {
+        return false;
+      }
+      for (at = scope->next; at < scope->bindings->count; at += 2) {
+        if (symbol == scope->bindings->data[at]) {
+          return true;
+        }
       }
+      return false;
     }
-    return t;
   }
+  return false;
 }
 
-void list_free(lvm_p this, gc_p list)
-{
-  (void)this;
-  free((void *)((list_p)list)->data);
-  free((void *)list);
-}
-
-vector_p vector_make(lvm_p this, size_t init)
+/* collects the symbols the body reads from outside its own bindings in
+ * order of first appearance; locals gets the ones read where
+ * closure_resolve rewrites symbols into local references. returns false
+ * when '..' needs the whole defining environment */
+bool closure_captures(lvm_p this, mal_p ast, scope_p scope, list_p outside,
+    list_p locals)
 {
-  vector_p vector = (vector_p)calloc(1, sizeof(vector_t));
+  list_p list;
+  scope_t inner;
+  mal_p symbol = ast;
+  mal_p head;
+  mal_p mal;
+  mal_p more;
+  size_t at = 0;
+  switch (ast->type) {
+  case MAL_LOCAL:
+    symbol = ast->as.local;
+    /* fall through */
+  case MAL_SYMBOL:
+    if (SPECIAL_ENV == symbol->special) {
+      return false;
+    }
+    if (SPECIAL_NONE != symbol->special ||
+        closure_bound(this, scope, symbol)) {
+      return true;
+    }
+    if (!list_find(this, outside, symbol)) {
+      list_append(this, outside, symbol);
+    }
+    if (locals && !list_find(this, locals, symbol)) {
+      list_append(this, locals, symbol);
+    }
+    return true;
+  case MAL_LIST:
+    list = ast->as.list;
+    if (0 == list->count) {
+      return true;
+    }
+    if (list->base) {
+      locals = NULL;
+    }
+    head = list->data[0];
+    switch (is_symbol(head) ? head->special : SPECIAL_NONE) {
+    case SPECIAL_DEF_BANG:
+      at = 2;
+      break;
+    case SPECIAL_LET_STAR:
+    case SPECIAL_LOOP:
+      if (list->count < 3 || !is_sequential(list->data[1])) {
+        locals = NULL;
+        at = 1;
+        break;
+      }
+      inner.symbols = list_make(this, 0);
+      inner.bindings = NULL;
+      inner.outer = scope;
+      if (is_list(list->data[1])) {
+        list_p bindings = list->data[1]->as.list;
+        for (at = 0; at + 1 < bindings->count; at += 2) {
+          if (!closure_captures(this, bindings->data[at + 1], &inner,
+              outside, locals)) {
+            return false;
+          }
+          list_append(this, inner.symbols, bindings->data[at]);
+        }
+      } else {
+        vector_p bindings = list->data[1]->as.vector;
+        for (at = 0; at < bindings->count; at += 2) {
+          if (at + 1 < bindings->count && !closure_captures(this,
+              vector_get(this, bindings, at + 1), &inner, outside, locals)) {
+            return false;
+          }
+          list_append(this, inner.symbols, vector_get(this, bindings, at));
+        }
+      }
+      return closure_captures(this, list->data[2], &inner, outside, locals);
+    case SPECIAL_FN_STAR:
+      if (list->count < 3) {
+        return true;
+      }
+      mal = list->data[1];
+      if (is_error(closure_parameters(this, &mal, &more))) {
+        return true;
+      }
+      inner.symbols = closure_scope(this, mal->as.list, more);
+      inner.bindings = NULL;
+      inner.outer = scope;
+      return closure_captures(this, list->data[2], &inner, outside, locals);
+    case SPECIAL_CATCH_STAR:
+      if (list->count < 3 || !is_symbol(list->data[1])) {
+        locals = NULL;
+        at = 1;
+        break;
+      }
+      inner.symbols = list_make(this, 1);
+      list_append(this, inner.symbols, list->data[1]);
+      inner.bindings = NULL;
+      inner.outer = scope;
+      return closure_captures(this, list->data[2], &inner, outside, locals);
+    case SPECIAL_NONE:
+      break;
+    default:
+      at = 1;
+      break;
+    }
+    for (; at < list->count; at++) {
+      if (!closure_captures(this, list->data[at], scope, outside, locals)) {
+        return false;
+      }
+    }
+    return NULL == list->tail ||
+        closure_captures(this, list->tail, scope, outside, locals);
+  case MAL_LAMBDA:
+    return closure_captures(this, ast->as.lambda->form, scope, outside,
+        locals);
+  case MAL_VECTOR:
+    for (at = 0; at < ast->as.vector->count; at++) {
+      if (!closure_captures(this, vector_get(this, ast->as.vector, at),
+          scope, outside, locals)) {
+        return false;
+      }
+    }
+    return true;
+  case MAL_HASHMAP:
+    list = hashmap_list(this, ast->as.hashmap);
+    for (at = 1; at < list->count; at += 2) {
+      if (!closure_captures(this, list->data[at], scope, outside, locals)) {
+        return false;
+      }
+    }
+    return true;
+  default:
+    return true;
+  }
+}
+
+/* checks and resolves a fn* form once, for every closure made from it.
+ * scope and defined describe the body the form sits in, when that body
+ * has been resolved: enclosing locals it reads get a slot in the capture
+ * frame, in order of first appearance */
+mal_p closure_lambda(lvm_p this, mal_p ast, scope_p scope, list_p defined)
+{
+  list_p list = ast->as.list;
+  lambda_p lambda;
+  mal_p result;
+  mal_p params;
+  mal_p more = NULL;
+  list_p locals;
+  scope_t inner;
+  scope_t captured;
+  size_t at;
+  if (2 > list->count) {
+    return mal_error(this, ERROR_RUNTIME, text_concat(this,
+        text_concat_text(this, text_make(this, "'fn*': has too few arguments '"),
+        text_make_integer(this, list->count - 1)),
+        "' missing parameters and body\n"));
+  }
+  if (3 > list->count) {
+    return mal_error(this, ERROR_RUNTIME, text_concat(this,
+        text_concat_text(this, text_make(this, "'fn*': has too few arguments '"),
+        text_make_integer(this, list->count - 1)), "' missing body\n"));
+  }
+  if (3 < list->count || list->tail) {
+    return mal_error(this, ERROR_RUNTIME, text_concat(this,
+        text_concat_text(this, text_make(this,
+        "'fn*': has too many arguments '"),
+        text_make_integer(this, list->count - 1)), "'\n"));
+  }
+  params = list->data[1];
+  result = closure_parameters(this, &params, &more);
+  if (is_error(result)) {
+    return result;
+  }
+  lambda = lambda_make(this, ast);
+  lambda->parameters = params;
+  lambda->more = more;
+  lambda->defined = list_make(this, 0);
+  lambda->outside = list_make(this, 0);
+  closure_defined(this, list->data[2], lambda->defined);
+  inner.symbols = closure_scope(this, params->as.list, more);
+  inner.bindings = NULL;
+  inner.outer = NULL;
+  locals = list_make(this, 0);
+  /* without the enclosing scope a frame may still bind any free symbol
+   * later, so only a closure analysed in place is flattened */
+  lambda->flat = closure_captures(this, list->data[2], &inner,
+      lambda->outside, locals) && scope;
+  captured.symbols = list_make(this, locals->count);
+  captured.bindings = NULL;
+  captured.outer = NULL;
+  for (at = 0; scope && at < lambda->outside->count; at++) {
+    mal_p symbol = lambda->outside->data[at];
+    if (defined && list_find(this, defined, symbol)) {
+      /* a def! in an enclosing frame may bind it after this closure is
+       * made, which a copy taken now would not see */
+      lambda->flat = false;
+    } else if (list_find(this, locals, symbol) &&
+        closure_bound(this, scope, symbol)) {
+      list_append(this, captured.symbols, symbol);
+      if (closure_pending(this, scope, symbol)) {
+        lambda->flat = false;
+      }
+    }
+  }
+  lambda->captured = captured.symbols;
+  inner.outer = &captured;
+  lambda->definition = closure_resolve(this, list->data[2], &inner,
+      lambda->defined);
+  return mal_lambda(this, lambda);
+}
+
+/* copies the outside symbols bound between env and the global
+ * environment into a fresh frame, the captured locals first so that
+ * their slots match the resolved body. falls back to the defining
+ * environment when a free symbol is bound nowhere yet, since a later
+ * def! may still bind it in an enclosing frame */
+env_p closure_env(lvm_p this, env_p env, lambda_p lambda)
+{
+  env_p capture;
+  mal_p symbol;
+  size_t at;
+  if (env == this->env || !lambda->flat) {
+    return env;
+  }
+  capture = env_make(this, this->env, NULL, 0, NULL, NULL,
+      lambda->outside->count << 1);
+  for (at = 0; at < lambda->captured->count; at++) {
+    if (!env_capture(this, env, capture, lambda->captured->data[at])) {
+      return env;
+    }
+  }
+  for (at = 0; at < lambda->outside->count; at++) {
+    symbol = lambda->outside->data[at];
+    if (list_find(this, lambda->captured, symbol) ||
+        env_capture(this, env, capture, symbol) ||
+        list_find(this, lambda->defined, symbol)) {
+      continue;
+    }
+    if (env_find(this, this->env, symbol) >= this->env->count) {
+      return env;
+    }
+  }
+  return capture;
+}
+
+bool closure_escapes(lvm_p this, mal_p ast)
+{
+  list_p list;
+  size_t at;
+  switch (ast->type) {
+  case MAL_SYMBOL:
+    return SPECIAL_FN_STAR == ast->special || SPECIAL_ENV == ast->special;
+  case MAL_LAMBDA:
+    return true;
+  case MAL_LIST:
+    list = ast->as.list;
+    for (at = 0; at < list->count; at++) {
+      if (closure_escapes(this, list->data[at])) {
+        return true;
+      }
+    }
+    return list->tail && closure_escapes(this, list->tail);
+  case MAL_VECTOR:
+    for (at = 0; at < ast->as.vector->count; at++) {
+      if (closure_escapes(this, vector_get(this, ast->as.vector, at))) {
+        return true;
+      }
+    }
+    return false;
+  case MAL_HASHMAP:
+    list = hashmap_list(this, ast->as.hashmap);
+    for (at = 0; at < list->count; at++) {
+      if (closure_escapes(this, list->data[at])) {
+        return true;
+      }
+    }
+    return false;
+  default:
+    return false;
+  }
+}
+
+void closure_free(lvm_p this, gc_p gc)
+{
+  slab_free(this, (void *)gc, sizeof(closure_t));
+}
+
+lambda_p lambda_make(lvm_p this, mal_p form)
+{
+  lambda_p lambda = (lambda_p)slab_alloc(this, sizeof(lambda_t));
+  lambda->form = form;
+  lambda->parameters = NULL;
+  lambda->more = NULL;
+  lambda->definition = NULL;
+  lambda->captured = NULL;
+  lambda->outside = NULL;
+  lambda->defined = NULL;
+  lambda->code = NULL;
+  lambda->flat = false;
+  lambda->gc.type = GC_LAMBDA;
+#if GC_ON
+  lambda->gc.mark = GC_WHITE;
+#else
+  lambda->gc.mark = GC_IMMORTAL;
+#endif
+  lambda->gc.next = this->gc.first;
+  this->gc.first = (gc_p)lambda;
+  this->gc.count++;
+  return lambda;
+}
+
+void lambda_free(lvm_p this, gc_p gc)
+{
+  slab_free(this, (void *)gc, sizeof(lambda_t));
+}
+
+code_p code_make(lvm_p this)
+{
+  code_p code = (code_p)slab_alloc(this, sizeof(code_t));
+  code->count = 0;
+  code->capacity = 8;
+  code->data = (instr_p)slab_alloc(this, code->capacity * sizeof(instr_t));
+  code->stack = false;
+  code->scope = NULL;
+  code->defined = NULL;
+  code->error = NULL;
+  code->loop.active = false;
+  code->loop.fresh = false;
+  code->loop.start = 0;
+  code->loop.count = 0;
+  code->loop.depth = 0;
+  code->gc.type = GC_CODE;
+#if GC_ON
+  code->gc.mark = GC_WHITE;
+#else
+  code->gc.mark = GC_IMMORTAL;
+#endif
+  code->gc.next = this->gc.first;
+  this->gc.first = (gc_p)code;
+  this->gc.count++;
+  return code;
+}
+
+size_t code_emit(lvm_p this, code_p code,
+    void (*op)(lvm_p this, frame_p frame, instr_p instr), size_t operand,
+    mal_p constant)
+{
+  if (code->count >= code->capacity) {
+    code->data = (instr_p)slab_realloc(this, code->data,
+        code->capacity * sizeof(instr_t),
+        (code->capacity << 1) * sizeof(instr_t));
+    code->capacity = code->capacity << 1;
+  }
+  code->data[code->count].op = op;
+  code->data[code->count].operand = operand;
+  code->data[code->count].constant = constant;
+  code->data[code->count].version = 0;
+  return code->count++;
+}
+
+void code_patch(lvm_p this, code_p code, size_t at)
+{
+  (void)this;
+  code->data[at].operand = code->count;
+}
+
+void code_free(lvm_p this, gc_p gc)
+{
+  slab_free(this, (void *)((code_p)gc)->data,
+      ((code_p)gc)->capacity * sizeof(instr_t));
+  slab_free(this, (void *)gc, sizeof(code_t));
+}
+
+list_p list_make(lvm_p this, size_t init)
+{
+  list_p list = (list_p)slab_alloc(this, sizeof(list_t));
   size_t capacity = 2;
   if (0 == init) {
     init = 2;
@@ -1260,86 +2157,182 @@ vector_p vector_make(lvm_p this, size_t init)
   while (capacity < init) {
     capacity = (capacity << 1);
   }
-  vector->count = 0;
-  vector->capacity = capacity;
-  vector->data = (mal_pp)calloc(capacity, sizeof(mal_p));
-  vector->gc.type = GC_VECTOR;
+  list->count = 0;
+  list->capacity = capacity;
+  list->data = (mal_pp)slab_alloc(this, capacity * sizeof(mal_p));
+  list->tail = NULL;
+  list->base = NULL;
+  list->gc.type = GC_LIST;
 #if GC_ON
-  vector->gc.mark = !this->gc.mark;
+  list->gc.mark = GC_WHITE;
 #else
-  vector->gc.mark = this->gc.mark;
+  list->gc.mark = GC_IMMORTAL;
 #endif
-  vector->gc.next = this->gc.first;
-  this->gc.first = (gc_p)vector;
+  list->gc.next = this->gc.first;
+  this->gc.first = (gc_p)list;
   this->gc.count++;
-  return vector;
+  return list;
 }
 
-bool vector_append(lvm_p this, vector_p vector, mal_p mal)
+bool list_append(lvm_p this, list_p list, mal_p mal)
 {
-  (void)this;
-  if (vector->count >= vector->capacity) {
+  if (list->base) {
+    size_t capacity = 2;
     mal_pp tmp;
-    vector->capacity <<= 1;
-    tmp = (mal_pp)realloc(vector->data, vector->capacity * sizeof(mal_p));
+    while (capacity <= list->count) {
+      capacity = (capacity << 1);
+    }
+    tmp = (mal_pp)slab_alloc(this, capacity * sizeof(mal_p));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_display_position(this,
+          reader_peek(this), "not enough memory"));
+      return false;
+    }
+    memcpy(tmp, list->data, list->count * sizeof(mal_p));
+    list->data = tmp;
+    list->capacity = capacity;
+    list->base = NULL;
+  }
+  if (list->count >= list->capacity) {
+    mal_pp tmp;
+    tmp = (mal_pp)slab_realloc(this, list->data,
+        list->capacity * sizeof(mal_p), (list->capacity << 1) * sizeof(mal_p));
     if (NULL == tmp) {
       error_append(this, ERROR_RUNTIME, text_display_position(this,
           reader_peek(this), "not enough memory"));
       return false;
     }
-    vector->data = tmp;
+    list->data = tmp;
+    list->capacity <<= 1;
   }
-  vector->data[vector->count++] = mal;
+  lvm_gc_barrier(this, (gc_p)list, (gc_p)mal);
+  list->data[list->count++] = mal;
   return true;
 }
 
-text_p vector_text(lvm_p this, vector_p vector)
+text_p list_text(lvm_p this, list_p list)
 {
-  text_p mal = text_make(this, "[");
+  text_p mal = text_make(this, "(");
   size_t at;
-  if (vector->count > 0) {
-    text_concat_text(this, mal, mal_print(this, vector->data[0], false));
-    for (at = 1; at < vector->count - 1; at++) {
+  for (at = 0; at < list->count; at++) {
+    if (at) {
       text_append(this, mal, ' ');
-      text_concat_text(this, mal, mal_print(this, vector->data[at], false));
     }
-    if (1 != at && text_cmp(this, mal_print(this, vector->data[at], false),
-        "nil")) {
-      text_concat(this, mal, " : ");
-      text_concat_text(this, mal, mal_print(this, vector->data[at], false));
+    text_concat_text(this, mal, mal_print(this, list->data[at], false));
+  }
+  if (list->tail) {
+    text_concat(this, mal, list->count ? " : " : ": ");
+    text_concat_text(this, mal, mal_print(this, list->tail, false));
+  }
+  return text_append(this, mal, ')');
+}
+
+text_p list_more_text(lvm_p this, list_p list, mal_p more)
+{
+  text_p mal = text_make(this, "(");
+  size_t at;
+  for (at = 0; at < list->count; at++) {
+    if (at) {
+      text_append(this, mal, ' ');
     }
+    text_concat_text(this, mal, mal_print(this, list->data[at], false));
   }
-  return text_append(this, mal, ']');
+  if (!is_nil(more)) {
+    text_concat(this, mal, list->count ? " & " : "& ");
+    text_concat_text(this, mal, mal_print(this, more, false));
+  }
+  return text_append(this, mal, ')');
 }
 
-mal_p vector_get(lvm_p this, vector_p vector, size_t offset)
+/* a slice is a view sharing the storage of its base list, which is
+ * never appended to once it is finished; appending to the view copies */
+list_p list_slice(lvm_p this, list_p original, size_t offset, size_t count)
+{
+  list_p slice;
+  if (offset >= original->count) {
+    slice = list_make(this, 0);
+    slice->tail = original->tail;
+    return slice;
+  }
+  if (count > original->count - offset) {
+    count = original->count - offset;
+  }
+  slice = (list_p)slab_alloc(this, sizeof(list_t));
+  slice->data = original->data + offset;
+  slice->count = count;
+  slice->capacity = 0;
+  slice->tail = offset + count == original->count ? original->tail : NULL;
+  slice->base = original->base ? original->base : original;
+  slice->gc.type = GC_LIST;
+#if GC_ON
+  slice->gc.mark = GC_WHITE;
+#else
+  slice->gc.mark = GC_IMMORTAL;
+#endif
+  slice->gc.next = this->gc.first;
+  this->gc.first = (gc_p)slice;
+  this->gc.count++;
+  return slice;
+}
+
+list_p list_offset(lvm_p this, list_p original, size_t offset)
+{
+  return list_slice(this, original, offset, original->count);
+}
+
+list_p list_params(lvm_p this, list_p original)
+{
+  return list_offset(this, original, 1);
+}
+
+mal_p list_get(lvm_p this, list_p list, size_t offset)
 {
   (void)this;
-  if (offset < vector->count) {
-    return vector->data[offset];
+  if (offset < list->count) {
+    return list->data[offset];
   } else {
     mal_p nil;
-    env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
+    nil = mal_nil(this);
     return nil;
   }
 }
 
-mal_p vector_equal(lvm_p this, vector_p vector0, vector_p vector1)
+mal_p list_find(lvm_p this, list_p list, mal_p symbol)
+{
+  size_t at;
+  (void)this;
+  for (at = 0; at < list->count; at++) {
+    if (symbol == list->data[at]) {
+      return list->data[at];
+    }
+  }
+  return NULL;
+}
+
+mal_p list_equal(lvm_p this, list_p list0, list_p list1)
 {
   mal_p t;
   mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if (vector0->count != vector1->count) {
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (list0->count != list1->count || !list0->tail != !list1->tail) {
     return f;
   } else {
     size_t at;
-    for (at = 0; at < vector0->count; at++) {
-      list_p args = list_make(this, 0);
+    for (at = 0; at <= list0->count; at++) {
+      mal_p args[2];
       mal_p cmp;
-      list_append(this, args, vector0->data[at]);
-      list_append(this, args, vector1->data[at]);
-      cmp = core_eq(this, mal_list(this, args));
+      if (at == list0->count) {
+        if (!list0->tail) {
+          break;
+        }
+        args[0] = list0->tail;
+        args[1] = list1->tail;
+      } else {
+        args[0] = list0->data[at];
+        args[1] = list1->data[at];
+      }
+      cmp = core_eq(this, 2, args);
       if (is_false(cmp)) {
         return f;
       }
@@ -1348,126 +2341,427 @@ mal_p vector_equal(lvm_p this, vector_p vector0, vector_p vector1)
   }
 }
 
-list_p vector_list(lvm_p this, vector_p vector)
+void list_free(lvm_p this, gc_p list)
 {
-  list_p list = list_make(this, vector->count);
-  size_t at = 0;
-  for (; at < vector->count; at++) {
-    list_append(this, list, vector->data[at]);
+  if (!((list_p)list)->base) {
+    slab_free(this, (void *)((list_p)list)->data,
+        ((list_p)list)->capacity * sizeof(mal_p));
   }
-  return list;
-}
-
-void vector_free(lvm_p this, gc_p vector)
-{
-  (void)this;
-  free((void *)((vector_p)vector)->data);
-  free((void *)vector);
+  slab_free(this, (void *)list, sizeof(list_t));
 }
 
-hashmap_p hashmap_make(lvm_p this, size_t init)
+vector_p vector_make(lvm_p this, size_t init)
 {
-  hashmap_p hashmap = (hashmap_p)calloc(1, sizeof(hashmap_t));
+  vector_p vector = (vector_p)slab_alloc(this, sizeof(vector_t));
   size_t capacity = 2;
   if (0 == init) {
     init = 2;
   }
-  while (capacity < init) {
+  while (capacity < init && capacity < VECTOR_WIDTH) {
     capacity = (capacity << 1);
   }
-  hashmap->count = 0;
-  hashmap->capacity = capacity;
-  hashmap->data = (mal_pp)calloc(capacity, sizeof(mal_p));
-  hashmap->gc.type = GC_HASHMAP;
+  vector->root = NULL;
+  vector->count = 0;
+  vector->shift = VECTOR_BITS;
+  vector->tail_count = 0;
+  vector->capacity = capacity;
+  vector->tail = (mal_pp)slab_alloc(this, capacity * sizeof(mal_p));
+  vector->gc.type = GC_VECTOR;
 #if GC_ON
-  hashmap->gc.mark = !this->gc.mark;
+  vector->gc.mark = GC_WHITE;
 #else
-  hashmap->gc.mark = this->gc.mark;
+  vector->gc.mark = GC_IMMORTAL;
 #endif
-  hashmap->gc.next = this->gc.first;
-  this->gc.first = (gc_p)hashmap;
+  vector->gc.next = this->gc.first;
+  this->gc.first = (gc_p)vector;
   this->gc.count++;
-  return hashmap;
+  return vector;
 }
 
-bool hashmap_set(lvm_p this, hashmap_p hashmap, mal_p key, mal_p value)
+vector_p vector_copy(lvm_p this, vector_p vector)
 {
-  size_t at = 0;
-  for  (at = 0; at < hashmap->count; at = at + 2) {
-    if (0 == text_cmp_text(this, hashmap->data[at]->signature, key->signature)
-        && hashmap->count >= at+1) {
-      hashmap->data[at+1] = value;
-      return true;
+  vector_p copy = vector_make(this, vector->capacity);
+  copy->root = vector->root;
+  copy->count = vector->count;
+  copy->shift = vector->shift;
+  copy->tail_count = vector->tail_count;
+  memcpy(copy->tail, vector->tail, vector->tail_count * sizeof(mal_p));
+  return copy;
+}
+
+bool vector_append(lvm_p this, vector_p vector, mal_p mal)
+{
+  if (VECTOR_WIDTH == vector->tail_count) {
+    vector_node_p leaf = vector_node_make(this, NULL);
+    vector_node_p root;
+    size_t at;
+    for (at = 0; at < VECTOR_WIDTH; at++) {
+      leaf->slots[at] = (gc_p)vector->tail[at];
+    }
+    if ((vector->count >> VECTOR_BITS) > ((size_t)1 << vector->shift)) {
+      root = vector_node_make(this, NULL);
+      root->slots[0] = (gc_p)vector->root;
+      root->slots[1] = (gc_p)vector_node_push(this, vector, vector->shift,
+          NULL, leaf);
+      vector->shift += VECTOR_BITS;
+    } else {
+      root = vector_node_push(this, vector, vector->shift, vector->root,
+          leaf);
+    }
+    lvm_gc_barrier(this, (gc_p)vector, (gc_p)root);
+    vector->root = root;
+    vector->tail_count = 0;
+  } else if (vector->tail_count >= vector->capacity) {
+    mal_pp tmp;
+    tmp = (mal_pp)slab_realloc(this, vector->tail,
+        vector->capacity * sizeof(mal_p),
+        (vector->capacity << 1) * sizeof(mal_p));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_display_position(this,
+          reader_peek(this), "not enough memory"));
+      return false;
     }
+    vector->tail = tmp;
+    vector->capacity <<= 1;
   }
-  hashmap_append(this, hashmap, key);
-  hashmap_append(this, hashmap, value);
+  lvm_gc_barrier(this, (gc_p)vector, (gc_p)mal);
+  vector->tail[vector->tail_count++] = mal;
+  vector->count++;
   return true;
 }
 
-bool hashmap_get(lvm_p this, hashmap_p hashmap, mal_p key, mal_pp value)
+bool vector_pop(lvm_p this, vector_p vector)
 {
-  size_t at = 0;
-  mal_p nil;
-  *value = NULL;
-  for  (at = 0; at < hashmap->count; at = at + 2) {
-    if (0 == text_cmp_text(this, hashmap->data[at]->signature, key->signature)) {
-      *value = hashmap->data[at+1];
-      return true;
+  vector_node_p leaf;
+  vector_node_p root;
+  size_t at;
+  if (0 == vector->count) {
+    return false;
+  }
+  if (1 < vector->tail_count || 1 == vector->count) {
+    vector->tail_count--;
+    vector->count--;
+    return true;
+  }
+  if (VECTOR_WIDTH > vector->capacity) {
+    mal_pp tmp;
+    tmp = (mal_pp)slab_realloc(this, vector->tail,
+        vector->capacity * sizeof(mal_p), VECTOR_WIDTH * sizeof(mal_p));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_make(this, "not enough memory"));
+      return false;
     }
+    vector->tail = tmp;
+    vector->capacity = VECTOR_WIDTH;
+  }
+  leaf = vector_node_leaf(vector, vector->count - 2);
+  for (at = 0; at < VECTOR_WIDTH; at++) {
+    vector->tail[at] = (mal_p)leaf->slots[at];
+  }
+  root = vector_node_pop(this, vector, vector->shift, vector->root);
+  if (root && VECTOR_BITS < vector->shift && NULL == root->slots[1]) {
+    root = (vector_node_p)root->slots[0];
+    vector->shift -= VECTOR_BITS;
+  }
+  lvm_gc_barrier(this, (gc_p)vector, (gc_p)root);
+  vector->root = root;
+  vector->tail_count = VECTOR_WIDTH;
+  vector->count--;
+  return true;
+}
+
+vector_p vector_assoc(lvm_p this, vector_p vector, size_t offset, mal_p mal)
+{
+  vector_p copy;
+  size_t tail = vector->count - vector->tail_count;
+  if (offset >= vector->count) {
+    return NULL;
   }
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  (*value) = nil;
-  return false;
+  copy = vector_copy(this, vector);
+  if (offset >= tail) {
+    copy->tail[offset - tail] = mal;
+  } else {
+    copy->root = vector_node_assoc(this, vector->shift, vector->root, offset,
+        mal);
+  }
+  return copy;
+}
+
+mal_p vector_get(lvm_p this, vector_p vector, size_t offset)
+{
+  size_t tail = vector->count - vector->tail_count;
+  if (offset >= vector->count) {
+    mal_p nil;
+    nil = mal_nil(this);
+    return nil;
+  } else if (offset >= tail) {
+    return vector->tail[offset - tail];
+  } else {
+    return (mal_p)vector_node_leaf(vector, offset)->slots[offset
+        & VECTOR_MASK];
+  }
+}
+
+vector_node_p vector_node_make(lvm_p this, vector_node_p copy)
+{
+  vector_node_p node;
+  node = (vector_node_p)slab_alloc(this, sizeof(vector_node_t));
+  if (copy) {
+    memcpy(node->slots, copy->slots, sizeof(node->slots));
+  }
+  node->gc.type = GC_VECTOR_NODE;
+#if GC_ON
+  node->gc.mark = GC_WHITE;
+#else
+  node->gc.mark = GC_IMMORTAL;
+#endif
+  node->gc.next = this->gc.first;
+  this->gc.first = (gc_p)node;
+  this->gc.count++;
+  return node;
+}
+
+vector_node_p vector_node_leaf(vector_p vector, size_t offset)
+{
+  vector_node_p node = vector->root;
+  size_t level;
+  for (level = vector->shift; level > 0; level -= VECTOR_BITS) {
+    node = (vector_node_p)node->slots[(offset >> level) & VECTOR_MASK];
+  }
+  return node;
+}
+
+vector_node_p vector_node_push(lvm_p this, vector_p vector, size_t level,
+    vector_node_p parent, vector_node_p leaf)
+{
+  vector_node_p node = vector_node_make(this, parent);
+  size_t at = ((vector->count - 1) >> level) & VECTOR_MASK;
+  if (VECTOR_BITS == level) {
+    node->slots[at] = (gc_p)leaf;
+  } else {
+    node->slots[at] = (gc_p)vector_node_push(this, vector,
+        level - VECTOR_BITS, (vector_node_p)node->slots[at], leaf);
+  }
+  return node;
 }
 
-bool hashmap_get_by_text(lvm_p this, hashmap_p hashmap, text_p key, mal_pp value)
+vector_node_p vector_node_pop(lvm_p this, vector_p vector, size_t level,
+    vector_node_p node)
 {
+  vector_node_p copy;
+  vector_node_p child = NULL;
+  size_t at = ((vector->count - 2) >> level) & VECTOR_MASK;
+  if (VECTOR_BITS < level) {
+    child = vector_node_pop(this, vector, level - VECTOR_BITS,
+        (vector_node_p)node->slots[at]);
+  }
+  if (NULL == child && 0 == at) {
+    return NULL;
+  }
+  copy = vector_node_make(this, node);
+  copy->slots[at] = (gc_p)child;
+  return copy;
+}
+
+vector_node_p vector_node_assoc(lvm_p this, size_t level, vector_node_p node,
+    size_t offset, mal_p mal)
+{
+  vector_node_p copy = vector_node_make(this, node);
+  size_t at = (offset >> level) & VECTOR_MASK;
+  if (0 == level) {
+    copy->slots[at] = (gc_p)mal;
+  } else {
+    copy->slots[at] = (gc_p)vector_node_assoc(this, level - VECTOR_BITS,
+        (vector_node_p)node->slots[at], offset, mal);
+  }
+  return copy;
+}
+
+void vector_node_free(lvm_p this, gc_p node)
+{
+  slab_free(this, (void *)node, sizeof(vector_node_t));
+}
+
+text_p vector_text(lvm_p this, vector_p vector)
+{
+  text_p mal = text_make(this, "[");
+  size_t at;
+  for (at = 0; at < vector->count; at++) {
+    if (at) {
+      text_append(this, mal, ' ');
+    }
+    text_concat_text(this, mal, mal_print(this, vector_get(this, vector, at),
+        false));
+  }
+  return text_append(this, mal, ']');
+}
+
+mal_p vector_equal(lvm_p this, vector_p vector0, vector_p vector1)
+{
+  mal_p t;
+  mal_p f;
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (vector0->count != vector1->count) {
+    return f;
+  } else {
+    size_t at;
+    for (at = 0; at < vector0->count; at++) {
+      mal_p args[2];
+      mal_p cmp;
+      args[0] = vector_get(this, vector0, at);
+      args[1] = vector_get(this, vector1, at);
+      cmp = core_eq(this, 2, args);
+      if (is_false(cmp)) {
+        return f;
+      }
+    }
+    return t;
+  }
+}
+
+list_p vector_list(lvm_p this, vector_p vector)
+{
+  list_p list = list_make(this, vector->count);
   size_t at = 0;
+  for (; at < vector->count; at++) {
+    list_append(this, list, vector_get(this, vector, at));
+  }
+  return list;
+}
+
+void vector_free(lvm_p this, gc_p vector)
+{
+  slab_free(this, (void *)((vector_p)vector)->tail,
+      ((vector_p)vector)->capacity * sizeof(mal_p));
+  slab_free(this, (void *)vector, sizeof(vector_t));
+}
+
+hashmap_p hashmap_make(lvm_p this, size_t init)
+{
+  hashmap_p hashmap = (hashmap_p)slab_alloc(this, sizeof(hashmap_t));
+  (void)init;
+  hashmap->root = NULL;
+  hashmap->count = 0;
+  hashmap->edit = ++this->edits;
+  hashmap->gc.type = GC_HASHMAP;
+#if GC_ON
+  hashmap->gc.mark = GC_WHITE;
+#else
+  hashmap->gc.mark = GC_IMMORTAL;
+#endif
+  hashmap->gc.next = this->gc.first;
+  this->gc.first = (gc_p)hashmap;
+  this->gc.count++;
+  return hashmap;
+}
+
+hashmap_p hashmap_copy(lvm_p this, hashmap_p hashmap)
+{
+  hashmap_p copy = hashmap_make(this, 0);
+  copy->root = hashmap->root;
+  copy->count = hashmap->count;
+  hashmap->edit = ++this->edits;
+  return copy;
+}
+
+bool hashmap_set(lvm_p this, hashmap_p hashmap, mal_p key, mal_p value)
+{
+  hashmap_node_p root;
+  bool added = false;
+  root = hashmap_node_assoc(this, hashmap->root, 0, mal_hash(this, key), key,
+      value, hashmap->edit, &added);
+  if (NULL == root) {
+    error_append(this, ERROR_RUNTIME, text_make(this, "not enough memory"));
+    return false;
+  }
+  lvm_gc_barrier(this, (gc_p)hashmap, (gc_p)root);
+  hashmap->root = root;
+  hashmap->count += added;
+  return true;
+}
+
+bool hashmap_get(lvm_p this, hashmap_p hashmap, mal_p key, mal_pp value)
+{
+  hashmap_node_p node = hashmap->root;
+  size_t hash = mal_hash(this, key);
+  size_t shift = 0;
+  size_t at;
   mal_p nil;
-  *value = NULL;
-  for  (at = 0; at < hashmap->count; at = at + 2) {
-    if (0 == text_cmp_text(this, hashmap->data[at]->signature, key)) {
-      *value = hashmap->data[at+1];
-      return true;
+  while (node) {
+    if (node->collision) {
+      for (at = 0; at < node->count; at++) {
+        if (mal_key_equal(this, (mal_p)node->data[at << 1], key)) {
+          *value = (mal_p)node->data[(at << 1) + 1];
+          return true;
+        }
+      }
+      break;
+    } else {
+      unsigned long bit = 1UL << ((hash >> shift) & HASHMAP_MASK);
+      if (!(node->bitmap & bit)) {
+        break;
+      }
+      at = hashmap_popcount(node->bitmap & (bit - 1)) << 1;
+      if (NULL == node->data[at]) {
+        node = (hashmap_node_p)node->data[at + 1];
+        shift += HASHMAP_BITS;
+      } else if (mal_key_equal(this, (mal_p)node->data[at], key)) {
+        *value = (mal_p)node->data[at + 1];
+        return true;
+      } else {
+        break;
+      }
     }
   }
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
+  nil = mal_nil(this);
   (*value) = nil;
   return false;
 }
 
-bool hashmap_append(lvm_p this, hashmap_p hashmap, mal_p mal)
+hashmap_p hashmap_assoc(lvm_p this, hashmap_p hashmap, mal_p key,
+    mal_p value)
 {
-  (void)this;
-  if (hashmap->count >= hashmap->capacity) {
-    mal_pp tmp;
-    hashmap->capacity <<= 1;
-    tmp = (mal_pp)realloc(hashmap->data, hashmap->capacity * sizeof(mal_p));
-    if (NULL == tmp) {
-      error_append(this, ERROR_RUNTIME, text_display_position(this,
-          reader_peek(this), "not enough memory"));
-      return false;
-    }
-    hashmap->data = tmp;
+  hashmap_p copy = hashmap_copy(this, hashmap);
+  if (!hashmap_set(this, copy, key, value)) {
+    return NULL;
   }
-  hashmap->data[hashmap->count++] = mal;
-  return true;
+  return copy;
+}
+
+hashmap_p hashmap_dissoc(lvm_p this, hashmap_p hashmap, mal_p key)
+{
+  hashmap_p copy = hashmap_copy(this, hashmap);
+  bool removed = false;
+  copy->root = hashmap_node_dissoc(this, copy->root, 0, mal_hash(this, key),
+      key, copy->edit, &removed);
+  copy->count -= removed;
+  return copy;
+}
+
+list_p hashmap_list(lvm_p this, hashmap_p hashmap)
+{
+  list_p list = list_make(this, hashmap->count << 1);
+  if (hashmap->root) {
+    hashmap_node_list(this, hashmap->root, list);
+  }
+  return list;
 }
 
 text_p hashmap_text(lvm_p this, hashmap_p hashmap)
 {
   text_p mal = text_make(this, "{");
+  list_p pairs = hashmap_list(this, hashmap);
   size_t i;
-  if (hashmap->count > 0) {
-    text_concat_text(this, mal, mal_print(this, hashmap->data[0], false));
+  if (pairs->count > 0) {
+    text_concat_text(this, mal, mal_print(this, pairs->data[0], false));
     text_concat(this, mal, ": ");
-    text_concat_text(this, mal, mal_print(this, hashmap->data[1], false));
-    for (i = 2; i < hashmap->count; i += 2) {
+    text_concat_text(this, mal, mal_print(this, pairs->data[1], false));
+    for (i = 2; i < pairs->count; i += 2) {
       text_append(this, mal, ' ');
-      text_concat_text(this, mal, mal_print(this, hashmap->data[i], false));
+      text_concat_text(this, mal, mal_print(this, pairs->data[i], false));
       text_concat(this, mal, ": ");
-      text_concat_text(this, mal, mal_print(this, hashmap->data[i + 1], false));
+      text_concat_text(this, mal, mal_print(this, pairs->data[i + 1], false));
     }
   }
   return text_append(this, mal, '}');
@@ -1477,28 +2771,28 @@ mal_p hashmap_equal(lvm_p this, hashmap_p hashmap0, hashmap_p hashmap1)
 {
   mal_p t;
   mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
   if (0 == hashmap0->count && 0 == hashmap1->count) {
     return t;
   }
   if (hashmap0->count != hashmap1->count) {
     return f;
   } else {
+    list_p pairs = hashmap_list(this, hashmap0);
     size_t at;
-    for (at = 0; at < hashmap0->count; at += 2) {
+    for (at = 0; at < pairs->count; at += 2) {
       mal_p cmp;
-      mal_p key0 = hashmap0->data[at];
-      mal_p value0 = hashmap0->data[at + 1];
+      mal_p key0 = pairs->data[at];
+      mal_p value0 = pairs->data[at + 1];
       mal_p value1 = NULL;
-      list_p args = list_make(this, 0);
-      hashmap_get(this, hashmap1, key0, &value1);
-      if (!value1) {
+      mal_p args[2];
+      if (!hashmap_get(this, hashmap1, key0, &value1)) {
         return f;
       }
-      list_append(this, args, value0);
-      list_append(this, args, value1);
-      cmp = core_eq(this, mal_list(this, args));
+      args[0] = value0;
+      args[1] = value1;
+      cmp = core_eq(this, 2, args);
       if (is_false(cmp)) {
         return f;
       }
@@ -1509,118 +2803,536 @@ mal_p hashmap_equal(lvm_p this, hashmap_p hashmap0, hashmap_p hashmap1)
 
 void hashmap_free(lvm_p this, gc_p hashmap)
 {
-  (void)this;
-  free((void *)((hashmap_p)hashmap)->data);
-  free((void *)hashmap);
+  slab_free(this, (void *)hashmap, sizeof(hashmap_t));
 }
 
-env_p env_make(lvm_p this, env_p outer, list_p symbols, list_p exprs,
-    mal_p more, size_t init)
+size_t hashmap_popcount(unsigned long bitmap)
 {
-  env_p env = (env_p)calloc(1, sizeof(env_t));
-  size_t capacity = 2;
-  size_t at = 0;
-  if (0 == init) {
-    init = 2;
+  bitmap = bitmap - ((bitmap >> 1) & 0x55555555UL);
+  bitmap = (bitmap & 0x33333333UL) + ((bitmap >> 2) & 0x33333333UL);
+  bitmap = (bitmap + (bitmap >> 4)) & 0x0f0f0f0fUL;
+  return (size_t)(((bitmap * 0x01010101UL) & 0xffffffffUL) >> 24);
+}
+
+hashmap_node_p hashmap_node_make(lvm_p this, size_t capacity, size_t edit)
+{
+  hashmap_node_p node;
+  node = (hashmap_node_p)slab_alloc(this, sizeof(hashmap_node_t));
+  if (NULL == node) {
+    return NULL;
   }
-  while (capacity < init) {
-    capacity = (capacity << 1);
+  node->data = (gc_pp)slab_alloc(this, (capacity << 1) * sizeof(gc_p));
+  if (NULL == node->data) {
+    slab_free(this, (void *)node, sizeof(hashmap_node_t));
+    return NULL;
   }
-  env->outer = outer;
-  env->hashmap = vector_make(this, init);
-  env->gc.type = GC_ENV;
+  node->bitmap = 0;
+  node->count = 0;
+  node->capacity = capacity;
+  node->hash = 0;
+  node->edit = edit;
+  node->collision = false;
+  node->gc.type = GC_HASHMAP_NODE;
 #if GC_ON
-  env->gc.mark = !this->gc.mark;
+  node->gc.mark = GC_WHITE;
 #else
-  env->gc.mark = this->gc.mark;
+  node->gc.mark = GC_IMMORTAL;
 #endif
-  env->gc.next = this->gc.first;
-  this->gc.first = (gc_p)env;
+  node->gc.next = this->gc.first;
+  this->gc.first = (gc_p)node;
   this->gc.count++;
-  if (symbols) {
-    for (; at < symbols->count - 1; at++) {
-      env_set(this, env, list_get(this, symbols, at),
-          list_get(this, exprs, at));
+  return node;
+}
+
+hashmap_node_p hashmap_node_edit(lvm_p this, hashmap_node_p node,
+    size_t capacity, size_t edit)
+{
+  hashmap_node_p copy;
+  if (node->edit == edit && node->capacity >= capacity) {
+    return node;
+  }
+  if (node->edit == edit) {
+    gc_pp tmp;
+    capacity = capacity > (node->capacity << 1) ? capacity :
+        node->capacity << 1;
+    tmp = (gc_pp)slab_realloc(this, node->data,
+        (node->capacity << 1) * sizeof(gc_p), (capacity << 1) * sizeof(gc_p));
+    if (NULL == tmp) {
+      return NULL;
     }
+    node->data = tmp;
+    node->capacity = capacity;
+    return node;
   }
-  if (more && !is_nil(more)) {
-    env_set(this, env, more, list_get(this, exprs, at));
+  copy = hashmap_node_make(this, capacity > node->count ? capacity :
+      node->count, edit);
+  if (NULL == copy) {
+    return NULL;
   }
-  return env;
+  memcpy(copy->data, node->data, (node->count << 1) * sizeof(gc_p));
+  copy->bitmap = node->bitmap;
+  copy->count = node->count;
+  copy->hash = node->hash;
+  copy->collision = node->collision;
+  return copy;
 }
 
-bool env_set(lvm_p this, env_p env, mal_p key, mal_p value)
+hashmap_node_p hashmap_node_pair(lvm_p this, size_t shift, mal_p key0,
+    mal_p value0, size_t hash1, mal_p key1, mal_p value1, size_t edit)
 {
-  size_t at = 0;
-  for (at = 0; at < env->hashmap->count; at = at + 2) {
-    if (0 == text_cmp_text(this, env->hashmap->data[at]->signature,
-        key->signature) && env->hashmap->count >= at + 1) {
-      env->hashmap->data[at+1] = value;
-      return true;
+  size_t hash0 = mal_hash(this, key0);
+  hashmap_node_p node;
+  bool added = false;
+  if (hash0 == hash1) {
+    node = hashmap_node_make(this, 2, edit);
+    if (NULL == node) {
+      return NULL;
     }
+    node->collision = true;
+    node->hash = hash1;
+    node->data[0] = (gc_p)key0;
+    node->data[1] = (gc_p)value0;
+    node->data[2] = (gc_p)key1;
+    node->data[3] = (gc_p)value1;
+    node->count = 2;
+    return node;
+  }
+  node = hashmap_node_assoc(this, NULL, shift, hash0, key0, value0, edit,
+      &added);
+  if (NULL == node) {
+    return NULL;
   }
-  vector_append(this, env->hashmap, key);
-  vector_append(this, env->hashmap, value);
-  return true;
+  return hashmap_node_assoc(this, node, shift, hash1, key1, value1, edit,
+      &added);
 }
 
-bool env_get(lvm_p this, env_p env, mal_p key, mal_pp value)
+hashmap_node_p hashmap_node_assoc(lvm_p this, hashmap_node_p node,
+    size_t shift, size_t hash, mal_p key, mal_p value, size_t edit,
+    bool *added)
 {
-  size_t at = 0;
-  (*value) = NULL;
-  while (env) {
-    for  (at = 0; at < env->hashmap->count; at = at + 2) {
-      if (0 == text_cmp_text(this, env->hashmap->data[at]->signature,
-          key->signature)) {
-        (*value) = env->hashmap->data[at+1];
-        return true;
+  unsigned long bit = 1UL << ((hash >> shift) & HASHMAP_MASK);
+  size_t at;
+  if (NULL == node) {
+    node = hashmap_node_make(this, 1, edit);
+    if (NULL == node) {
+      return NULL;
+    }
+    node->bitmap = bit;
+    node->data[0] = (gc_p)key;
+    node->data[1] = (gc_p)value;
+    node->count = 1;
+    *added = true;
+    return node;
+  }
+  if (node->collision) {
+    if (node->hash != hash) {
+      hashmap_node_p parent = hashmap_node_make(this, 1, edit);
+      if (NULL == parent) {
+        return NULL;
       }
+      parent->bitmap = 1UL << ((node->hash >> shift) & HASHMAP_MASK);
+      parent->data[0] = NULL;
+      parent->data[1] = (gc_p)node;
+      parent->count = 1;
+      return hashmap_node_assoc(this, parent, shift, hash, key, value, edit,
+          added);
     }
-    env = env->outer;
+    for (at = 0; at < node->count; at++) {
+      if (mal_key_equal(this, (mal_p)node->data[at << 1], key)) {
+        if ((gc_p)value == node->data[(at << 1) + 1]) {
+          return node;
+        }
+        node = hashmap_node_edit(this, node, node->count, edit);
+        if (node) {
+          hashmap_node_put(this, node, (at << 1) + 1, (gc_p)value);
+        }
+        return node;
+      }
+    }
+    node = hashmap_node_edit(this, node, node->count + 1, edit);
+    if (node) {
+      hashmap_node_put(this, node, node->count << 1, (gc_p)key);
+      hashmap_node_put(this, node, (node->count << 1) + 1, (gc_p)value);
+      node->count++;
+      *added = true;
+    }
+    return node;
+  }
+  at = hashmap_popcount(node->bitmap & (bit - 1)) << 1;
+  if (node->bitmap & bit) {
+    gc_p current = node->data[at];
+    gc_p child = node->data[at + 1];
+    bool split = false;
+    if (NULL == current) {
+      hashmap_node_p next = hashmap_node_assoc(this, (hashmap_node_p)child,
+          shift + HASHMAP_BITS, hash, key, value, edit, added);
+      if (NULL == next) {
+        return NULL;
+      }
+      if ((gc_p)next == child) {
+        return node;
+      }
+      child = (gc_p)next;
+    } else if (mal_key_equal(this, (mal_p)current, key)) {
+      if ((gc_p)value == child) {
+        return node;
+      }
+      child = (gc_p)value;
+    } else {
+      child = (gc_p)hashmap_node_pair(this, shift + HASHMAP_BITS,
+          (mal_p)current, (mal_p)child, hash, key, value, edit);
+      if (NULL == child) {
+        return NULL;
+      }
+      split = true;
+      *added = true;
+    }
+    node = hashmap_node_edit(this, node, node->count, edit);
+    if (node) {
+      if (split) {
+        node->data[at] = NULL;
+      }
+      hashmap_node_put(this, node, at + 1, child);
+    }
+    return node;
   }
-  return false;
+  node = hashmap_node_edit(this, node, node->count + 1, edit);
+  if (NULL == node) {
+    return NULL;
+  }
+  memmove(&node->data[at + 2], &node->data[at],
+      ((node->count << 1) - at) * sizeof(gc_p));
+  hashmap_node_put(this, node, at, (gc_p)key);
+  hashmap_node_put(this, node, at + 1, (gc_p)value);
+  node->bitmap |= bit;
+  node->count++;
+  *added = true;
+  return node;
 }
 
-bool env_get_by_text(lvm_p this, env_p env, text_p key, mal_pp value)
+hashmap_node_p hashmap_node_dissoc(lvm_p this, hashmap_node_p node,
+    size_t shift, size_t hash, mal_p key, size_t edit, bool *removed)
 {
-  size_t at = 0;
-  (*value) = NULL;
-  while (env) {
-    for  (at = 0; at < env->hashmap->count; at = at + 2) {
-      if (0 == text_cmp_text(this, env->hashmap->data[at]->signature, key)) {
-        (*value) = env->hashmap->data[at+1];
-        return true;
+  unsigned long bit = 1UL << ((hash >> shift) & HASHMAP_MASK);
+  size_t at;
+  if (NULL == node) {
+    return NULL;
+  }
+  if (node->collision) {
+    for (at = 0; at < node->count; at++) {
+      if (mal_key_equal(this, (mal_p)node->data[at << 1], key)) {
+        break;
       }
     }
-    env = env->outer;
+    if (at == node->count) {
+      return node;
+    }
+    at <<= 1;
+  } else {
+    if (!(node->bitmap & bit)) {
+      return node;
+    }
+    at = hashmap_popcount(node->bitmap & (bit - 1)) << 1;
+    if (NULL == node->data[at]) {
+      hashmap_node_p child = (hashmap_node_p)node->data[at + 1];
+      hashmap_node_p next = hashmap_node_dissoc(this, child,
+          shift + HASHMAP_BITS, hash, key, edit, removed);
+      if (next == child) {
+        return node;
+      }
+      if (next) {
+        node = hashmap_node_edit(this, node, node->count, edit);
+        hashmap_node_put(this, node, at + 1, (gc_p)next);
+        return node;
+      }
+    } else if (!mal_key_equal(this, (mal_p)node->data[at], key)) {
+      return node;
+    }
   }
-  return false;
+  *removed = true;
+  if (1 == node->count) {
+    return NULL;
+  }
+  node = hashmap_node_edit(this, node, node->count, edit);
+  memmove(&node->data[at], &node->data[at + 2],
+      ((node->count << 1) - at - 2) * sizeof(gc_p));
+  node->bitmap &= ~bit;
+  node->count--;
+  return node;
 }
 
-text_p env_text(lvm_p this, env_p env)
+void hashmap_node_put(lvm_p this, hashmap_node_p node, size_t at, gc_p gc)
 {
-  text_p mal = text_make(this, "{");
-  size_t i;
-  if (env->hashmap->count > 0) {
-    text_concat_text(this, mal, mal_print(this, env->hashmap->data[0], false));
-    text_concat(this, mal, ": ");
-    text_concat_text(this, mal, mal_print(this, env->hashmap->data[1], false));
-    for (i = 2; i < env->hashmap->count; i += 2) {
-      text_append(this, mal, ' ');
-      text_concat_text(this, mal, mal_print(this, env->hashmap->data[i],
-          false));
-      text_concat(this, mal, ": ");
-      text_concat_text(this, mal, mal_print(this, env->hashmap->data[i + 1],
-          false));
+  lvm_gc_barrier(this, (gc_p)node, gc);
+  node->data[at] = gc;
+}
+
+void hashmap_node_list(lvm_p this, hashmap_node_p node, list_p list)
+{
+  size_t at;
+  for (at = 0; at < (node->count << 1); at += 2) {
+    if (NULL == node->data[at]) {
+      hashmap_node_list(this, (hashmap_node_p)node->data[at + 1], list);
+    } else {
+      list_append(this, list, (mal_p)node->data[at]);
+      list_append(this, list, (mal_p)node->data[at + 1]);
     }
   }
-  return text_append(this, mal, '}');
+}
+
+void hashmap_node_free(lvm_p this, gc_p node)
+{
+  slab_free(this, (void *)((hashmap_node_p)node)->data,
+      (((hashmap_node_p)node)->capacity << 1) * sizeof(gc_p));
+  slab_free(this, (void *)node, sizeof(hashmap_node_t));
+}
+
+env_p env_make(lvm_p this, env_p outer, list_p symbols, size_t argc,
+    mal_pp argv, mal_p more, size_t init)
+{
+  env_p env = env_alloc(this, outer, init);
+#if GC_ON
+  env->gc.mark = GC_WHITE;
+#else
+  env->gc.mark = GC_IMMORTAL;
+#endif
+  env->gc.next = this->gc.first;
+  this->gc.first = (gc_p)env;
+  this->gc.count++;
+  return env_bind(this, env, symbols, argc, argv, more);
+}
+
+env_p env_push(lvm_p this, env_p outer, list_p symbols, size_t argc,
+    mal_pp argv, mal_p more, size_t init)
+{
+  envs_p stack = &this->envs;
+  env_p env;
+  if (stack->count >= stack->capacity) {
+    env_pp tmp;
+    size_t capacity = stack->capacity ? stack->capacity << 1 : 64;
+    tmp = (env_pp)realloc(stack->data, capacity * sizeof(env_p));
+    if (NULL == tmp) {
+      return env_make(this, outer, symbols, argc, argv, more, init);
+    }
+    stack->data = tmp;
+    stack->capacity = capacity;
+  }
+  env = env_alloc(this, outer, init);
+  env->gc.mark = GC_STACK;
+  env->gc.next = NULL;
+  stack->data[stack->count++] = env;
+  return env_bind(this, env, symbols, argc, argv, more);
+}
+
+void env_pop(lvm_p this, size_t base)
+{
+  while (this->envs.count > base) {
+    env_free(this, (gc_p)this->envs.data[--this->envs.count]);
+  }
+}
+
+env_p env_alloc(lvm_p this, env_p outer, size_t init)
+{
+  env_p env = (env_p)slab_alloc(this, sizeof(env_t));
+  size_t capacity = 2;
+  if (0 == init) {
+    init = 2;
+  }
+  while (capacity < init) {
+    capacity = (capacity << 1);
+  }
+  env->outer = outer;
+  env->count = 0;
+  env->capacity = capacity;
+  env->data = (mal_pp)slab_alloc(this, capacity * sizeof(mal_p));
+  env->index = NULL;
+  env->mask = 0;
+  env->shadow = false;
+  env->gc.type = GC_ENV;
+  return env;
+}
+
+env_p env_bind(lvm_p this, env_p env, list_p symbols, size_t argc,
+    mal_pp argv, mal_p more)
+{
+  size_t at = 0;
+  if (symbols) {
+    for (; at < symbols->count; at++) {
+      env_set(this, env, list_get(this, symbols, at),
+          at < argc ? argv[at] : mal_nil(this));
+    }
+  }
+  if (more && !is_nil(more)) {
+    list_p rest = list_make(this, argc > at ? argc - at : 0);
+    for (; at < argc; at++) {
+      list_append(this, rest, argv[at]);
+    }
+    env_set(this, env, more, mal_list(this, rest));
+  }
+  return env;
+}
+
+size_t env_find(lvm_p this, env_p env, mal_p key)
+{
+  size_t at;
+  if (env->index) {
+    at = key->hash & env->mask;
+    while (env->index[at]) {
+      size_t pair = env->index[at] - 1;
+      if (mal_key_equal(this, env->data[pair], key)) {
+        return pair;
+      }
+      at = (at + 1) & env->mask;
+    }
+    return env->count;
+  }
+  for (at = 0; at < env->count; at = at + 2) {
+    if (mal_key_equal(this, env->data[at], key)) {
+      return at;
+    }
+  }
+  return env->count;
+}
+
+bool env_index(lvm_p this, env_p env, size_t capacity)
+{
+  size_t *index = (size_t *)slab_alloc(this, capacity * sizeof(size_t));
+  size_t pair;
+  if (NULL == index) {
+    return false;
+  }
+  if (env->index) {
+    slab_free(this, (void *)env->index, (env->mask + 1) * sizeof(size_t));
+  }
+  env->index = index;
+  env->mask = capacity - 1;
+  for (pair = 0; pair < env->count; pair = pair + 2) {
+    size_t at = env->data[pair]->hash & env->mask;
+    while (env->index[at]) {
+      at = (at + 1) & env->mask;
+    }
+    env->index[at] = pair + 1;
+  }
+  return true;
+}
+
+bool env_set(lvm_p this, env_p env, mal_p key, mal_p value)
+{
+  size_t pair = env_find(this, env, key);
+  if (pair < env->count) {
+    lvm_gc_barrier(this, (gc_p)env, (gc_p)value);
+    env->data[pair + 1] = value;
+    return true;
+  }
+  if (env->count + 2 > env->capacity) {
+    mal_pp tmp;
+    tmp = (mal_pp)slab_realloc(this, env->data,
+        env->capacity * sizeof(mal_p), (env->capacity << 1) * sizeof(mal_p));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_make(this, "not enough memory"));
+      return false;
+    }
+    env->data = tmp;
+    env->capacity <<= 1;
+  }
+  lvm_gc_barrier(this, (gc_p)env, (gc_p)key);
+  lvm_gc_barrier(this, (gc_p)env, (gc_p)value);
+  env->data[env->count++] = key;
+  env->data[env->count++] = value;
+  if (env->index && env->count > env->mask) {
+    return env_index(this, env, (env->mask + 1) << 1);
+  } else if (env->index) {
+    size_t at = key->hash & env->mask;
+    while (env->index[at]) {
+      at = (at + 1) & env->mask;
+    }
+    env->index[at] = pair + 1;
+  } else if ((env->count >> 1) > ENV_LINEAR) {
+    return env_index(this, env, ENV_LINEAR << 2);
+  }
+  return true;
+}
+
+bool env_get(lvm_p this, env_p env, mal_p key, mal_pp value)
+{
+  (*value) = NULL;
+  while (env) {
+    size_t pair = env_find(this, env, key);
+    if (pair < env->count) {
+      (*value) = env->data[pair + 1];
+      return true;
+    }
+    env = env->outer;
+  }
+  return false;
+}
+
+bool env_capture(lvm_p this, env_p env, env_p capture, mal_p key)
+{
+  for (; env && env != this->env; env = env->outer) {
+    size_t pair = env_find(this, env, key);
+    if (pair < env->count) {
+      capture->shadow = capture->shadow || env->shadow;
+      return env_set(this, capture, key, env->data[pair + 1]);
+    }
+  }
+  return false;
+}
+
+mal_p env_local(lvm_p this, env_p env, mal_p local)
+{
+  env_p frame = env;
+  size_t depth = local->hash >> LOCAL_BITS;
+  size_t slot = (local->hash & LOCAL_MASK) << 1;
+  for (; depth && frame; depth--) {
+    frame = frame->outer;
+  }
+  if (frame && slot < frame->count && local->as.local == frame->data[slot]) {
+    return frame->data[slot + 1];
+  }
+  return eval_ast(this, local->as.local, env);
+}
+
+void env_shadow(lvm_p this, env_p env, mal_p key)
+{
+  /* a new binding that hides a global invalidates the call site caches,
+   * and code running under its frame stops trusting them, since closures
+   * of one fn* form share their code but not their frames */
+  if (env != this->env && env_find(this, this->env, key) < this->env->count) {
+    this->version++;
+    env->shadow = true;
+  }
+}
+
+text_p env_text(lvm_p this, env_p env)
+{
+  text_p mal = text_make(this, "{");
+  size_t i;
+  if (env->count > 0) {
+    text_concat_text(this, mal, mal_print(this, env->data[0], false));
+    text_concat(this, mal, ": ");
+    text_concat_text(this, mal, mal_print(this, env->data[1], false));
+    for (i = 2; i < env->count; i += 2) {
+      text_append(this, mal, ' ');
+      text_concat_text(this, mal, mal_print(this, env->data[i],
+          false));
+      text_concat(this, mal, ": ");
+      text_concat_text(this, mal, mal_print(this, env->data[i + 1],
+          false));
+    }
+  }
+  return text_append(this, mal, '}');
 }
 
 void env_free(lvm_p this, gc_p env)
 {
-  (void)this;
-  free((void *)env);
+  slab_free(this, (void *)((env_p)env)->data,
+      ((env_p)env)->capacity * sizeof(mal_p));
+  if (((env_p)env)->index) {
+    slab_free(this, (void *)((env_p)env)->index,
+        (((env_p)env)->mask + 1) * sizeof(size_t));
+  }
+  slab_free(this, (void *)env, sizeof(env_t));
 }
 
 #if __STDC__
@@ -1788,7 +3500,7 @@ token_p tokenizer_scan(lvm_p this)
 
 token_p token_make(lvm_p this)
 {
-  token_p token = (token_p)calloc(1, sizeof(token_t));
+  token_p token = (token_p)slab_alloc(this, sizeof(token_t));
   reader_p reader = readers_get(this);
   if (reader) {
     token->line = reader->line;
@@ -1799,9 +3511,9 @@ token_p token_make(lvm_p this)
   }
   token->gc.type = GC_TOKEN;
 #if GC_ON
-  token->gc.mark = !this->gc.mark;
+  token->gc.mark = GC_WHITE;
 #else
-  token->gc.mark = this->gc.mark;
+  token->gc.mark = GC_IMMORTAL;
 #endif
   token->gc.next = this->gc.first;
   this->gc.first = (gc_p)token;
@@ -2138,6 +3850,7 @@ token_p token_string(lvm_p this)
   while (0x00 != (ch = tokenizer_peek(this))) {
     switch (ch) {
     case '"':
+      tokenizer_next(this);
       text_append(this, text, 0x00);
       token->length = text->count;
       token->as.string = text;
@@ -2181,8 +3894,7 @@ token_p token_string(lvm_p this)
 
 void token_free(lvm_p this, gc_p gc)
 {
-  (void)this;
-  free((void *)((token_p)gc));
+  slab_free(this, (void *)gc, sizeof(token_t));
 }
 
 reader_p reader_make(lvm_p this, char *str)
@@ -2238,8 +3950,10 @@ mal_p read_str(lvm_p this, char *str)
 {
   (void)str;
   if (TOKEN_EOI == reader_peek(this)->type) {
+    readers_pop(this);
     return mal_eoi(this);
   } else if (0 < this->error->count) {
+    readers_pop(this);
     return mal_eoi(this);
   } else {
     mal_p mal = read_form(this);
@@ -2252,7 +3966,6 @@ mal_p read_form(lvm_p this)
 {
   token_p token = reader_peek(this);
   list_p list = list_make(this, 0);
-  mal_p mal;
   mal_p first;
   mal_p second;
   while (true) {
@@ -2262,7 +3975,7 @@ mal_p read_form(lvm_p this)
     case TOKEN_QUOTE:
       return read_symbol_list(this, "quote");
     case TOKEN_LPAREN:
-      return read_list(this);
+      return positions_set(this, read_list(this), token);
     case TOKEN_RPAREN:
       return mal_error(this, ERROR_READER, text_display_position(this, token,
           "unbalanced parenthesis, expected '('"));
@@ -2272,7 +3985,7 @@ mal_p read_form(lvm_p this)
     case TOKEN_AT:
       return read_symbol_list(this, "deref");
     case TOKEN_LBRACKET:
-      return read_vector(this);
+      return positions_set(this, read_vector(this), token);
     case TOKEN_BACKSLASH:
       return mal_error(this, ERROR_READER, text_display_position(this, token,
           "unexpected backslash character '\\'"));
@@ -2289,8 +4002,6 @@ mal_p read_form(lvm_p this)
       case MAL_SYMBOL:
         list_append(this, list, second);
         list_append(this, list, first);
-        env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
-        list_append(this, list, mal);
         return mal_list(this, list);
       default:
         return mal_error(this, ERROR_READER, text_display_position(this, token,
@@ -2299,7 +4010,7 @@ mal_p read_form(lvm_p this)
     case TOKEN_BACKTICK:
       return read_symbol_list(this, "quasiquote");
     case TOKEN_LBRACE:
-      return read_hashmap(this);
+      return positions_set(this, read_hashmap(this), token);
     case TOKEN_RBRACE:
       return mal_error(this, ERROR_READER, text_display_position(this, token,
           "unbalanced brackets, expected '{'"));
@@ -2340,11 +4051,14 @@ mal_p read_parenthesis(lvm_p this)
           return mal_error(this, ERROR_READER, text_display_position(this,
               beginning, "unbalanced parenthesis, expected ')'"));
         } else {
-          if (0 == list->count) {
-            env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
-            list_append(this, list, mal);
+          mal = read_form(this);
+          list->tail = is_nil(mal) ? NULL : mal;
+          token = reader_peek(this);
+          if (TOKEN_RPAREN != token->type) {
+            return mal_error(this, ERROR_READER, text_display_position(this,
+                beginning, "unbalanced parenthesis, expected ')'"));
           }
-          list_append(this, list, read_form(this));
+          (void)reader_next(this);
           return mal_list(this, list);
         }
       }
@@ -2356,8 +4070,6 @@ mal_p read_parenthesis(lvm_p this)
       }
     }
     token = reader_next(this);
-    env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
-    list_append(this, list, mal);
     return mal_list(this, list);
   }
 }
@@ -2372,7 +4084,6 @@ mal_p read_brackets(lvm_p this)
   token_p beginning = reader_peek(this);
   token_p token = reader_next(this);
   vector_p vector = vector_make(this, 0);
-  mal_p mal;
   switch (token->type) {
   case TOKEN_EOI:
     return mal_error(this, ERROR_READER, text_display_position(this, beginning,
@@ -2383,18 +4094,8 @@ mal_p read_brackets(lvm_p this)
   default:
     while (TOKEN_RBRACKET != token->type) {
       if (TOKEN_COLON == token->type) {
-        token = reader_next(this);
-        if (TOKEN_EOI == token->type) {
-          return mal_error(this, ERROR_READER, text_display_position(this,
-              beginning, "unbalanced brackets, expected ']'"));
-        } else {
-          if (0 == vector->count) {
-            env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
-            vector_append(this, vector, mal);
-          }
-          vector_append(this, vector, read_form(this));
-          return mal_vector(this, vector);
-        }
+        return mal_error(this, ERROR_READER, text_display_position(this,
+            token, "unexpected colon ':'"));
       }
       vector_append(this, vector, read_form(this));
       token = reader_peek(this);
@@ -2404,8 +4105,6 @@ mal_p read_brackets(lvm_p this)
       }
     }
     token = reader_next(this);
-    env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
-    vector_append(this, vector, mal);
     return mal_vector(this, vector);
   }
 }
@@ -2448,7 +4147,7 @@ mal_p read_braces(lvm_p this)
         return mal_error(this, ERROR_READER, text_display_position(this,
             beginning, "unbalanced braces, expected '}'"));
       case TOKEN_RBRACE:
-        env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
+        mal = mal_nil(this);
         value = mal;
         break;
       default:
@@ -2479,21 +4178,21 @@ mal_p read_atom(lvm_p this)
     return mal_nil(this);
   case TOKEN_BOOLEAN:
     if (0 == text_cmp(this, token->as.boolean, "true")) {
-      env_get_by_text(this, this->env, text_make(this, "boolean: true"), &mal);
+      mal = mal_boolean(this, true);
       return mal;
     } else {
-      env_get_by_text(this, this->env, text_make(this, "boolean: false"), &mal);
+      mal = mal_boolean(this, false);
       return mal;
     }
   case TOKEN_SYMBOL:
     if (0 == text_cmp(this, token->as.symbol, "nil")) {
-      env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
+      mal = mal_nil(this);
       return mal;
     } else if (0 == text_cmp(this, token->as.symbol, "true")) {
-      env_get_by_text(this, this->env, text_make(this, "boolean: true"), &mal);
+      mal = mal_boolean(this, true);
       return mal;
     } else if (0 == text_cmp(this, token->as.symbol, "false")) {
-      env_get_by_text(this, this->env, text_make(this, "boolean: false"), &mal);
+      mal = mal_boolean(this, false);
       return mal;
     } else {
       return mal_symbol(this, token->as.symbol);
@@ -2515,28 +4214,26 @@ mal_p read_atom(lvm_p this)
 mal_p read_symbol_list(lvm_p this, char *name)
 {
   list_p list = list_make(this, 0);
-  mal_p mal;
   reader_next(this);
   list_append(this, list, mal_symbol(this, text_make(this, name)));
   list_append(this, list, read_form(this));
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &mal);
-  list_append(this, list, mal);
   return mal_list(this, list);
 }
 
 mal_p mal_make(lvm_p this, mal_type type)
 {
-  mal_p mal = (mal_p)calloc(1, sizeof(mal_t));
+  mal_p mal = (mal_p)slab_alloc(this, sizeof(mal_t));
   mal->type = type;
+  mal->special = SPECIAL_NONE;
   mal->as.nil = NULL;
-  mal->token = token_make(this);
+  mal->hash = 0;
   mal->gc.type = GC_MAL;
   mal->gc.next = this->gc.first;
   this->gc.first = (gc_p)mal;
 #if GC_ON
-  mal->gc.mark = !this->gc.mark;
+  mal->gc.mark = GC_WHITE;
 #else
-  mal->gc.mark = this->gc.mark;
+  mal->gc.mark = GC_IMMORTAL;
 #endif
   this->gc.count++;
   return mal;
@@ -2544,29 +4241,25 @@ mal_p mal_make(lvm_p this, mal_type type)
 
 mal_p mal_eoi(lvm_p this)
 {
-  mal_p mal = mal_make(this, MAL_EOI);
-  text_p eoi = text_make(this, "eoi");
-  text_p identity = eoi;
-  text_p signature = text_make(this, "eoi: eoi");
-  mal->as.eoi = eoi;
-  mal->token->as.eoi = eoi;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
+  mal_p mal;
+  if (this->constant.eoi) {
+    return this->constant.eoi;
+  }
+  mal = mal_make(this, MAL_EOI);
+  lvm_immortal(this, (gc_p)mal);
+  this->constant.eoi = mal;
   return mal;
 }
 
 mal_p mal_nil(lvm_p this)
 {
-  mal_p mal = mal_make(this, MAL_NIL);
-  text_p nil = text_make(this, "nil");
-  text_p identity = nil;
-  text_p signature = text_make(this, "nil: nil");
-  mal->as.nil = nil;
-  mal->token->as.nil = nil;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
+  mal_p mal;
+  if (this->constant.nil) {
+    return this->constant.nil;
+  }
+  mal = mal_make(this, MAL_NIL);
+  lvm_immortal(this, (gc_p)mal);
+  this->constant.nil = mal;
   return mal;
 }
 
@@ -2574,8 +4267,6 @@ mal_p mal_error(lvm_p this, error_type type, text_p text)
 {
   mal_p mal = mal_make(this, MAL_ERROR);
   text_p error;
-  text_p identity;
-  text_p signature = text_concat_text(this, text_make(this, "error: "), text);
   switch (type) {
   case ERROR_NONE:
     error = text_concat_text(this, text_make(this, "OK: "), text);
@@ -2593,199 +4284,132 @@ mal_p mal_error(lvm_p this, error_type type, text_p text)
     error = text_concat_text(this, text_make(this, "UNKNOWN ERROR: "), text);
     break;
   }
-  identity = error;
   mal->as.error = error;
-  mal->token->as.error = error;
   error_append(this, type, text);
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_boolean(lvm_p this, bool boolean)
 {
-  mal_p mal = mal_make(this, MAL_BOOLEAN);
-  text_p text;
-  text_p identity;
-  text_p signature = text_make(this, "boolean: ");
-  if (boolean) {
-    text = text_make(this, "true");
-  } else {
-    text = text_make(this, "false");
+  mal_p mal;
+  if (this->constant.boolean[boolean ? 1 : 0]) {
+    return this->constant.boolean[boolean ? 1 : 0];
   }
-  identity = text;
+  mal = mal_make(this, MAL_BOOLEAN);
   mal->as.boolean = boolean;
-  mal->token->as.boolean = text;
-  mal->signature = text_concat_text(this, signature, text);
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
+  lvm_immortal(this, (gc_p)mal);
+  this->constant.boolean[boolean ? 1 : 0] = mal;
   return mal;
 }
 
 mal_p mal_symbol(lvm_p this, text_p symbol)
 {
-  mal_p mal = mal_make(this, MAL_SYMBOL);
-  text_p identity = symbol;
-  text_p signature = text_concat_text(this, text_make(this, "symbol: "),
-      symbol);
-  mal->as.symbol = symbol;
-  mal->token->as.symbol = symbol;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
-  return mal;
+  return symbols_intern(this, MAL_SYMBOL, symbol);
 }
 
 mal_p mal_keyword(lvm_p this, text_p keyword)
 {
-  mal_p mal = mal_make(this, MAL_KEYWORD);
-  text_p identity = keyword;
-  text_p signature = text_concat_text(this, text_make(this, "keyword: "),
-      keyword);
-  mal->as.keyword = keyword;
-  mal->token->as.keyword = keyword;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
-  return mal;
+  return symbols_intern(this, MAL_KEYWORD, keyword);
 }
 
 mal_p mal_string(lvm_p this, text_p string)
 {
   mal_p mal = mal_make(this, MAL_STRING);
-  text_p identity = string;
-  text_p signature = text_concat_text(this, text_make(this, "string: "),
-      string);
   mal->as.string = string;
-  mal->token->as.string = string;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_function(lvm_p this, function_p function)
 {
   mal_p mal = mal_make(this, MAL_FUNCTION);
-  text_p identity = function->name;
-  text_p signature = text_concat_text(this, text_make(this, "function: "),
-      function->name);
   mal->as.function = function;
-  mal->token->as.function = function->name;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_closure(lvm_p this, closure_p closure)
 {
   mal_p mal = mal_make(this, MAL_CLOSURE);
-  text_p identity = closure_text(this, closure);
-  text_p signature = text_concat_text(this, text_make(this, "closure: "),
-      identity);
   mal->as.closure = closure;
-  mal->token->as.closure = identity;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_list(lvm_p this, list_p list)
 {
   mal_p mal = mal_make(this, MAL_LIST);
-  text_p identity = list_text(this, list);
-  text_p signature = text_concat_text(this, text_make(this, "list: "),
-      list_text(this, list));
   mal->as.list = list;
-  mal->token->as.list = identity;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_vector(lvm_p this, vector_p vector)
 {
   mal_p mal = mal_make(this, MAL_VECTOR);
-  text_p identity = vector_text(this, vector);
-  text_p signature = text_concat_text(this, text_make(this, "vector: "),
-      vector_text(this, vector));
   mal->as.vector = vector;
-  mal->token->as.vector = identity;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_hashmap(lvm_p this, hashmap_p hashmap)
 {
   mal_p mal = mal_make(this, MAL_HASHMAP);
-  text_p identity = hashmap_text(this, hashmap);
-  text_p signature = text_concat_text(this, text_make(this, "hashmap: "),
-      hashmap_text(this, hashmap));
   mal->as.hashmap = hashmap;
-  mal->token->as.hashmap = identity;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_env(lvm_p this, env_p env)
 {
   mal_p mal = mal_make(this, MAL_ENV);
-  text_p identity = env_text(this, env);
-  text_p signature = text_concat_text(this, text_make(this, "env: "),
-      env_text(this, env));
   mal->as.env = env;
-  mal->token->as.env = identity;
-  mal->signature = signature;
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_integer(lvm_p this, long integer)
 {
-  mal_p mal = mal_make(this, MAL_INTEGER);
-  text_p identity = text_make_integer(this, integer);
-  text_p signature = text_make(this, "integer: ");
+  mal_p mal;
+  if (this->constant.integer && SMALL_INTEGER_MIN <= integer &&
+      SMALL_INTEGER_MAX > integer) {
+    mal = this->constant.integer[integer - SMALL_INTEGER_MIN];
+    if (mal) {
+      return mal;
+    }
+  }
+  mal = mal_make(this, MAL_INTEGER);
   mal->as.integer = integer;
-  mal->token->as.number = identity;
-  mal->signature = text_concat_text(this, signature, identity);
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
 mal_p mal_decimal(lvm_p this, double decimal)
 {
   mal_p mal = mal_make(this, MAL_DECIMAL);
-  text_p identity = text_make_decimal(this, decimal);
-  text_p signature = text_make(this, "decimal: ");
   mal->as.decimal = decimal;
-  mal->token->as.number = identity;
-  mal->signature = text_concat_text(this, signature, identity);
-  mal->identity = identity;
-  mal->hash = text_hash_jenkins(this, signature);
   return mal;
 }
 
-mal_p mal_as_str(lvm_p this, mal_p args, bool readable, char *separator)
+mal_p mal_local(lvm_p this, mal_p symbol, size_t depth, size_t slot)
+{
+  mal_p mal = mal_make(this, MAL_LOCAL);
+  mal->as.local = symbol;
+  mal->hash = (depth << LOCAL_BITS) | slot;
+  return mal;
+}
+
+mal_p mal_lambda(lvm_p this, lambda_p lambda)
+{
+  mal_p mal = mal_make(this, MAL_LAMBDA);
+  mal->as.lambda = lambda;
+  return mal;
+}
+
+mal_p mal_as_str(lvm_p this, size_t argc, mal_pp argv, bool readable,
+    char *separator)
 {
   text_p text = text_make(this, "");
   size_t at;
-  for (at = 0; at < args->as.list->count - 2; at++) {
-    text_concat_text(this, text, mal_print(this, args->as.list->data[at],
+  for (at = 0; at < argc; at++) {
+    if (at) {
+      text_concat(this, text, separator);
+    }
+    text_concat_text(this, text, mal_print(this, argv[at],
         readable));
-    text_concat(this, text, separator);
   }
-  text_concat_text(this, text, mal_print(this, args->as.list->data[at],
-      readable));
   return mal_string(this, text);
 }
 
@@ -2803,6 +4427,7 @@ mal_p mal_type_of(lvm_p this, mal_p mal)
   case MAL_DECIMAL:
     return mal_symbol(this, text_make(this, "decimal"));
   case MAL_SYMBOL:
+  case MAL_LOCAL:
     return mal_symbol(this, text_make(this, "symbol"));
   case MAL_KEYWORD:
     return mal_symbol(this, text_make(this, "keyword"));
@@ -2813,6 +4438,7 @@ mal_p mal_type_of(lvm_p this, mal_p mal)
   case MAL_FUNCTION:
     return mal_symbol(this, text_make(this, "function"));
   case MAL_CLOSURE:
+  case MAL_LAMBDA:
     return mal_symbol(this, text_make(this, "closure"));
   case MAL_LIST:
     return mal_symbol(this, text_make(this, "list"));
@@ -2849,80 +4475,72 @@ text_p mal_print(lvm_p this, mal_p mal, bool readable)
     return mal->as.function->name;
   case MAL_CLOSURE:
     return closure_text(this, mal->as.closure);
+  case MAL_LOCAL:
+    return mal_print(this, mal->as.local, readable);
+  case MAL_LAMBDA:
+    return mal_print(this, mal->as.lambda->form, readable);
   case MAL_LIST:
     text = text_make(this, "(");
-    if (mal->as.list->count > 0) {
-      if (!(mal->as.list->count == 1 && is_nil(mal->as.list->data[0]))) {
-        text_concat_text(this, text, mal_print(this, mal->as.list->data[0],
-            readable));
-      }
-      for (; i < (mal->as.list->count - 1); i++) {
+    for (i = 0; i < mal->as.list->count; i++) {
+      if (i) {
         text_append(this, text, ' ');
-        text_concat_text(this, text, mal_print(this, mal->as.list->data[i],
-            readable));
-      }
-      if (i != 1 && !is_nil(mal->as.list->data[i])) {
-        text_concat(this, text, " : ");
-        text_concat_text(this, text, mal_print(this,
-            mal->as.list->data[i], readable));
       }
+      text_concat_text(this, text, mal_print(this, mal->as.list->data[i],
+          readable));
+    }
+    if (mal->as.list->tail) {
+      text_concat(this, text, mal->as.list->count ? " : " : ": ");
+      text_concat_text(this, text, mal_print(this, mal->as.list->tail,
+          readable));
     }
     text_append(this, text, ')');
     return text_append(this, text, 0x00);
   case MAL_VECTOR:
     text = text_make(this, "[");
-    if (mal->as.vector->count > 0) {
-      if (!(mal->as.vector->count == 1 && is_nil(mal->as.vector->data[0]))) {
-        text_concat_text(this, text, mal_print(this, mal->as.vector->data[0],
-            readable));
-      }
-      for (; i < (mal->as.vector->count - 1); i++) {
+    for (i = 0; i < mal->as.vector->count; i++) {
+      if (i) {
         text_append(this, text, ' ');
-        text_concat_text(this, text, mal_print(this, mal->as.vector->data[i],
-            readable));
-      }
-      if (i != 1 && !is_nil(mal->as.vector->data[i])) {
-        text_concat(this, text, " : ");
-        text_concat_text(this, text, mal_print(this,
-            mal->as.vector->data[i], readable));
       }
+      text_concat_text(this, text, mal_print(this,
+          vector_get(this, mal->as.vector, i), readable));
     }
     text_append(this, text, ']');
     return text_append(this, text, 0x00);
   case MAL_HASHMAP:
     text = text_make(this, "{");
     if (mal->as.hashmap->count > 0) {
-      text_concat_text(this, text, mal_print(this, mal->as.hashmap->data[0],
+      list_p pairs = hashmap_list(this, mal->as.hashmap);
+      text_concat_text(this, text, mal_print(this, pairs->data[0],
           readable));
       text_concat(this, text, ": ");
-      text_concat_text(this, text, mal_print(this, mal->as.hashmap->data[1],
+      text_concat_text(this, text, mal_print(this, pairs->data[1],
           readable));
-      for (i = 2; i < (mal->as.hashmap->count); i += 2) {
+      for (i = 2; i < pairs->count; i += 2) {
         text_append(this, text, ' ');
-        text_concat_text(this, text, mal_print(this, mal->as.hashmap->data[i],
+        text_concat_text(this, text, mal_print(this, pairs->data[i],
             readable));
         text_concat(this, text, ": ");
-        text_concat_text(this, text, mal_print(this,
-            mal->as.hashmap->data[i + 1], readable));
+        text_concat_text(this, text, mal_print(this, pairs->data[i + 1],
+            readable));
       }
     }
     text_append(this, text, '}');
     return text_append(this, text, 0x00);
   case MAL_ENV:
     text = text_make(this, "{");
-    if (mal->as.env->hashmap->count > 0) {
+    if (mal->as.env->count > 0) {
       text_concat_text(this, text, mal_print(this,
-          mal->as.env->hashmap->data[0], readable));
+          mal->as.env->data[0], readable));
       text_concat(this, text, ": ");
       text_concat_text(this, text, mal_print(this,
-          mal->as.env->hashmap->data[1], readable));
-      for (i = 2; i < (mal->as.env->hashmap->count); i += 2) {
+          mal->as.env->data[1], readable));
+      for (i = 2; i < (mal->as.env->count); i += 2) {
         text_append(this, text, ' ');
         text_concat_text(this, text, mal_print(this,
-            mal->as.env->hashmap->data[i], readable));
+            mal->as.env->data[i], readable));
         text_concat(this, text, ": ");
         text_concat_text(this, text, mal_print(this,
-            mal->as.env->hashmap->data[i + 1], readable));
+            mal->as.env->data[i + 1], readable));
       }
     }
     text_append(this, text, '}');
@@ -2946,14 +4564,22 @@ text_p mal_print(lvm_p this, mal_p mal, bool readable)
     return text_make_decimal(this, mal->as.decimal);
   default:
     return error_append(this, ERROR_PRINTER,
-        text_display_position(this, mal->token, "unknown type of object"));
+        mal_display_position(this, mal, "unknown type of object"));
   }
 }
 
+text_p mal_display_position(lvm_p this, mal_p mal, char *text)
+{
+  position_p position = positions_get(this, mal);
+  token_t token;
+  token.line = position ? position->line : 0;
+  token.column = position ? position->column : 0;
+  return text_display_position(this, &token, text);
+}
+
 void mal_free(lvm_p this, gc_p mal)
 {
-  (void)this;
-  free((void *)((mal_p)mal));
+  slab_free(this, (void *)mal, sizeof(mal_t));
 }
 
 bool is_eoi(mal_p mal)
@@ -3001,6 +4627,16 @@ bool is_symbol(mal_p mal)
   return (MAL_SYMBOL == mal->type);
 }
 
+bool is_local(mal_p mal)
+{
+  return (MAL_LOCAL == mal->type);
+}
+
+bool is_lambda(mal_p mal)
+{
+  return (MAL_LAMBDA == mal->type);
+}
+
 bool is_keyword(mal_p mal)
 {
   return (MAL_KEYWORD == mal->type);
@@ -3058,170 +4694,532 @@ bool is_callable(mal_p mal)
   return (MAL_FUNCTION == mal->type || MAL_CLOSURE == mal->type);
 }
 
+bool is_interned(mal_p mal)
+{
+  return (MAL_SYMBOL == mal->type || MAL_KEYWORD == mal->type);
+}
+
+bool mal_key_equal(lvm_p this, mal_p key0, mal_p key1)
+{
+  if (key0 == key1) {
+    return true;
+  }
+  if (key0->type != key1->type || is_interned(key0) || is_interned(key1)) {
+    return false;
+  }
+  switch (key0->type) {
+  case MAL_EOI:
+  case MAL_NIL:
+    return true;
+  case MAL_BOOLEAN:
+    return key0->as.boolean == key1->as.boolean;
+  case MAL_INTEGER:
+    return key0->as.integer == key1->as.integer;
+  case MAL_DECIMAL:
+    return key0->as.decimal == key1->as.decimal;
+  case MAL_STRING:
+    return 0 == text_cmp_text(this, key0->as.string, key1->as.string);
+  case MAL_FUNCTION:
+    return key0->as.function == key1->as.function;
+  default:
+    return 0 == text_cmp_text(this, mal_print(this, key0, true),
+        mal_print(this, key1, true));
+  }
+}
+
+size_t mal_hash(lvm_p this, mal_p mal)
+{
+  size_t hash = 2166136261U;
+  unsigned char *byte;
+  size_t at;
+  switch (mal->type) {
+  case MAL_SYMBOL:
+  case MAL_KEYWORD:
+    return mal->hash & 0xffffffffUL;
+  case MAL_BOOLEAN:
+    return mal->as.boolean ? 1231 : 1237;
+  case MAL_INTEGER:
+    hash = (size_t)mal->as.integer;
+    hash = (hash ^ (hash >> 16)) * 0x45d9f3bUL;
+    return (hash ^ (hash >> 16)) & 0xffffffffUL;
+  case MAL_DECIMAL:
+    if (0.0 == mal->as.decimal) {
+      return 0;
+    }
+    byte = (unsigned char *)&mal->as.decimal;
+    for (at = 0; at < sizeof(mal->as.decimal); at++) {
+      hash ^= byte[at];
+      hash *= 16777619;
+    }
+    return hash & 0xffffffffUL;
+  case MAL_STRING:
+    return text_hash_fnv_1a(this, mal->as.string) & 0xffffffffUL;
+  case MAL_FUNCTION:
+    return ((size_t)mal->as.function >> 4) & 0xffffffffUL;
+  case MAL_EOI:
+  case MAL_NIL:
+    return (size_t)mal->type;
+  default:
+    return text_hash_fnv_1a(this, mal_print(this, mal, true)) & 0xffffffffUL;
+  }
+}
+
 lvm_p lvm_make()
 {
   lvm_p lvm = (lvm_p)calloc(1, sizeof(lvm_t));
   mal_p mal;
-  lvm->gc.mark = 0;
+  size_t at;
+  struct {
+    char *symbol;
+    special_type special;
+  } specials[] = {
+    {"def!", SPECIAL_DEF_BANG},
+    {"let*", SPECIAL_LET_STAR},
+    {"if", SPECIAL_IF},
+    {"fn*", SPECIAL_FN_STAR},
+    {"do", SPECIAL_DO},
+    {"..", SPECIAL_ENV},
+    {"try*", SPECIAL_TRY_STAR},
+    {"catch*", SPECIAL_CATCH_STAR},
+    {"loop", SPECIAL_LOOP},
+    {"recur", SPECIAL_RECUR},
+    {NULL, SPECIAL_NONE}
+  };
+  lvm->gc.mark = GC_BLACK;
+  lvm->gc.major = false;
   lvm->gc.count = 0;
-  lvm->gc.total = 8;
+  lvm->gc.total = GC_NURSERY;
+  lvm->gc.old_count = 0;
+  lvm->gc.old_total = GC_NURSERY;
   lvm->gc.first = NULL;
+  lvm->gc.old = NULL;
+  lvm->gc.immortal = NULL;
+  lvm->gc.remembered.data = NULL;
+  lvm->gc.remembered.count = 0;
+  lvm->gc.remembered.capacity = 0;
+  lvm->gc.gray.data = NULL;
+  lvm->gc.gray.count = 0;
+  lvm->gc.gray.capacity = 0;
+  lvm->constant.eoi = NULL;
+  lvm->constant.nil = NULL;
+  lvm->constant.boolean[0] = NULL;
+  lvm->constant.boolean[1] = NULL;
+  lvm->constant.integer = NULL;
   lvm->readers.count = 0;
   lvm->readers.capacity = 1 << 1;
+  lvm->symbols.data = NULL;
+  lvm->symbols.count = 0;
+  lvm->symbols.capacity = 0;
+  lvm->positions.data = NULL;
+  lvm->positions.count = 0;
+  lvm->positions.capacity = 0;
+  lvm->roots.data = NULL;
+  lvm->roots.count = 0;
+  lvm->roots.capacity = 0;
+  lvm->values.data = NULL;
+  lvm->values.count = 0;
+  lvm->values.capacity = 0;
+  lvm->frames.data = NULL;
+  lvm->frames.count = 0;
+  lvm->frames.capacity = 0;
+  lvm->frames.max = FRAMES_MAX;
+  lvm->frames.depth = 0;
+  lvm->frames.depth_max = EVAL_DEPTH_MAX;
+  lvm->catches.data = NULL;
+  lvm->catches.count = 0;
+  lvm->catches.capacity = 0;
+  lvm->envs.data = NULL;
+  lvm->envs.count = 0;
+  lvm->envs.capacity = 0;
+  lvm->handler = NULL;
+  slab_init(lvm);
+  lvm->edits = 0;
+  lvm->version = 1;
   /*readers_push(lvm, reader_make(lvm, ""));*/
   lvm->error = NULL;
   lvm->comment = NULL;
-  lvm->env = env_make(lvm, NULL, NULL, NULL, NULL, 0);
-  mal = mal_nil(lvm);
-  env_set(lvm, lvm->env, mal, mal);
-  mal = mal_boolean(lvm, true);
-  env_set(lvm, lvm->env, mal, mal);
-  mal = mal_boolean(lvm, false);
-  env_set(lvm, lvm->env, mal, mal);
+  lvm->env = env_make(lvm, NULL, NULL, 0, NULL, NULL, 0);
+  mal_eoi(lvm);
+  mal_nil(lvm);
+  mal_boolean(lvm, true);
+  mal_boolean(lvm, false);
+  lvm->constant.integer = (mal_pp)calloc(SMALL_INTEGER_MAX -
+      SMALL_INTEGER_MIN, sizeof(mal_p));
+  for (at = 0; at < SMALL_INTEGER_MAX - SMALL_INTEGER_MIN; at++) {
+    mal = mal_integer(lvm, SMALL_INTEGER_MIN + (long)at);
+    lvm_immortal_mark(lvm, (gc_p)mal);
+    lvm->constant.integer[at] = mal;
+  }
+  lvm_immortal_pin(lvm);
+  for (at = 0; specials[at].symbol; at++) {
+    mal = mal_symbol(lvm, text_make(lvm, specials[at].symbol));
+    mal->special = specials[at].special;
+  }
   return lvm;
 }
 
-void lvm_gc_mark(lvm_p this, gc_p gc)
+void lvm_immortal(lvm_p this, gc_p gc)
 {
-  size_t at;
-  if (this->gc.mark == gc->mark) {
-    return;
-  }
-  gc->mark = this->gc.mark;
-  switch (gc->type) {
-  case GC_TEXT:
-    break;
-  case GC_FUNCTION:
-    ((function_p)gc)->gc.mark = this->gc.mark;
-    lvm_gc_mark(this, (gc_p)(((function_p)gc)->name));
-    break;
-  case GC_CLOSURE:
-    ((closure_p)gc)->gc.mark = this->gc.mark;
-    lvm_gc_mark(this, (gc_p)(((closure_p)gc)->parameters));
-    lvm_gc_mark(this, (gc_p)(((closure_p)gc)->more));
-    lvm_gc_mark(this, (gc_p)(((closure_p)gc)->definition));
-    break;
-  case GC_LIST:
-    gc->mark = this->gc.mark;
-    for (at = 0; at < ((list_p)gc)->count; at++) {
-      lvm_gc_mark(this, (gc_p)(((list_p)gc)->data[at]));
+  lvm_immortal_mark(this, gc);
+  lvm_immortal_pin(this);
+}
+
+void lvm_immortal_mark(lvm_p this, gc_p gc)
+{
+  int mark = this->gc.mark;
+  bool major = this->gc.major;
+  this->gc.mark = GC_IMMORTAL;
+  this->gc.major = true;
+  lvm_gc_mark(this, gc);
+  this->gc.mark = mark;
+  this->gc.major = major;
+}
+
+void lvm_immortal_pin(lvm_p this)
+{
+  gc_pp obj = &this->gc.first;
+  size_t *count = &this->gc.count;
+  while (true) {
+    while (*obj) {
+      if (GC_IMMORTAL == (*obj)->mark) {
+        gc_p immortal = (*obj);
+        (*obj) = immortal->next;
+        immortal->next = this->gc.immortal;
+        this->gc.immortal = immortal;
+        (*count)--;
+      } else {
+        obj = &(*obj)->next;
+      }
     }
-    break;
-  case GC_VECTOR:
-    gc->mark = this->gc.mark;
-    for (at = 0; at < ((vector_p)gc)->count; at++) {
-      lvm_gc_mark(this, (gc_p)(((vector_p)gc)->data[at]));
+    if (count == &this->gc.old_count) {
+      break;
     }
-    break;
-  case GC_HASHMAP:
-    ((hashmap_p)gc)->gc.mark = this->gc.mark;
-    for (at = 0; at < ((hashmap_p)gc)->count; at++) {
-      lvm_gc_mark(this, (gc_p)(((hashmap_p)gc)->data[at]));
+    obj = &this->gc.old;
+    count = &this->gc.old_count;
+  }
+}
+
+bool lvm_gc_unmarked(lvm_p this, gc_p gc)
+{
+  switch (gc->mark) {
+  case GC_WHITE:
+    return true;
+  case GC_OLD:
+  case GC_REMEMBERED:
+    return this->gc.major;
+  default:
+    return false;
+  }
+}
+
+void lvm_gc_barrier(lvm_p this, gc_p container, gc_p value)
+{
+  if (GC_OLD != container->mark || NULL == value || GC_WHITE != value->mark) {
+    return;
+  }
+  if (this->gc.remembered.count >= this->gc.remembered.capacity) {
+    gc_pp tmp;
+    size_t capacity = this->gc.remembered.capacity ?
+        this->gc.remembered.capacity << 1 : 256;
+    tmp = (gc_pp)realloc(this->gc.remembered.data, capacity * sizeof(gc_p));
+    if (NULL == tmp) {
+      this->gc.old_total = 0;
+      return;
+    }
+    this->gc.remembered.data = tmp;
+    this->gc.remembered.capacity = capacity;
+  }
+  container->mark = GC_REMEMBERED;
+  this->gc.remembered.data[this->gc.remembered.count++] = container;
+}
+
+void lvm_gc_mark(lvm_p this, gc_p gc)
+{
+  lvm_gc_gray(this, gc);
+  lvm_gc_drain(this);
+}
+
+void lvm_gc_drain(lvm_p this)
+{
+  gc_pp gray;
+  gc_p gc;
+  while (this->gc.gray.count) {
+    gray = this->gc.gray.data;
+    gc = gray[--this->gc.gray.count];
+    if (this->gc.gray.count) {
+      GC_PREFETCH(gray[this->gc.gray.count - 1]);
+    }
+    lvm_gc_scan(this, gc);
+  }
+}
+
+void lvm_gc_gray(lvm_p this, gc_p gc)
+{
+  if (NULL == gc || !lvm_gc_unmarked(this, gc)) {
+    return;
+  }
+  gc->mark = this->gc.mark;
+  if (this->gc.gray.count >= this->gc.gray.capacity) {
+    gc_pp tmp;
+    size_t capacity = this->gc.gray.capacity ?
+        this->gc.gray.capacity << 1 : 256;
+    tmp = (gc_pp)realloc(this->gc.gray.data, capacity * sizeof(gc_p));
+    if (NULL == tmp) {
+      lvm_gc_scan(this, gc);
+      return;
+    }
+    this->gc.gray.data = tmp;
+    this->gc.gray.capacity = capacity;
+  }
+  this->gc.gray.data[this->gc.gray.count++] = gc;
+}
+
+void lvm_gc_scan(lvm_p this, gc_p gc)
+{
+  size_t at;
+  switch (gc->type) {
+  case GC_TEXT:
+    break;
+  case GC_FUNCTION:
+    lvm_gc_gray(this, (gc_p)(((function_p)gc)->name));
+    break;
+  case GC_CLOSURE:
+    lvm_gc_gray(this, (gc_p)(((closure_p)gc)->env));
+    lvm_gc_gray(this, (gc_p)(((closure_p)gc)->lambda));
+    break;
+  case GC_LAMBDA:
+    lvm_gc_gray(this, (gc_p)(((lambda_p)gc)->form));
+    lvm_gc_gray(this, (gc_p)(((lambda_p)gc)->parameters));
+    lvm_gc_gray(this, (gc_p)(((lambda_p)gc)->more));
+    lvm_gc_gray(this, (gc_p)(((lambda_p)gc)->definition));
+    lvm_gc_gray(this, (gc_p)(((lambda_p)gc)->captured));
+    lvm_gc_gray(this, (gc_p)(((lambda_p)gc)->outside));
+    lvm_gc_gray(this, (gc_p)(((lambda_p)gc)->defined));
+    lvm_gc_gray(this, (gc_p)(((lambda_p)gc)->code));
+    break;
+  case GC_CODE:
+    for (at = 0; at < ((code_p)gc)->count; at++) {
+      lvm_gc_gray(this, (gc_p)(((code_p)gc)->data[at].constant));
+    }
+    break;
+  case GC_LIST:
+    lvm_gc_gray(this, (gc_p)(((list_p)gc)->tail));
+    if (((list_p)gc)->base) {
+      lvm_gc_gray(this, (gc_p)(((list_p)gc)->base));
+      break;
+    }
+    for (at = 0; at < ((list_p)gc)->count; at++) {
+      lvm_gc_gray(this, (gc_p)(((list_p)gc)->data[at]));
+    }
+    break;
+  case GC_VECTOR:
+    lvm_gc_gray(this, (gc_p)(((vector_p)gc)->root));
+    for (at = 0; at < ((vector_p)gc)->tail_count; at++) {
+      lvm_gc_gray(this, (gc_p)(((vector_p)gc)->tail[at]));
+    }
+    break;
+  case GC_VECTOR_NODE:
+    for (at = 0; at < VECTOR_WIDTH; at++) {
+      lvm_gc_gray(this, ((vector_node_p)gc)->slots[at]);
+    }
+    break;
+  case GC_HASHMAP:
+    lvm_gc_gray(this, (gc_p)(((hashmap_p)gc)->root));
+    break;
+  case GC_HASHMAP_NODE:
+    for (at = 0; at < (((hashmap_node_p)gc)->count << 1); at++) {
+      lvm_gc_gray(this, ((hashmap_node_p)gc)->data[at]);
     }
     break;
   case GC_ENV:
-    ((env_p)gc)->hashmap->gc.mark = this->gc.mark;
-    for (at = 0; at < ((env_p)gc)->hashmap->count; at++) {
-      lvm_gc_mark(this, (gc_p)(((env_p)gc)->hashmap->data[at]));
+    lvm_gc_gray(this, (gc_p)(((env_p)gc)->outer));
+    for (at = 0; at < ((env_p)gc)->count; at++) {
+      lvm_gc_gray(this, (gc_p)(((env_p)gc)->data[at]));
     }
     break;
   case GC_ERROR:
     for (at = 0; at < ((error_p)gc)->count; at++) {
-      lvm_gc_mark(this, (gc_p)(((error_p)gc)->data[at]));
+      lvm_gc_gray(this, (gc_p)(((error_p)gc)->data[at]));
     }
     break;
   case GC_COMMENT:
     for (at = 0; at < ((comment_p)gc)->count; at++) {
-      lvm_gc_mark(this, (gc_p)(((comment_p)gc)->data[at]));
+      lvm_gc_gray(this, (gc_p)(((comment_p)gc)->data[at]));
     }
     break;
   case GC_TOKEN:
     break;
   case GC_MAL:
-    ((mal_p)gc)->gc.mark = this->gc.mark;
     switch (((mal_p)gc)->type) {
     case MAL_FUNCTION:
-      lvm_gc_mark(this, (gc_p)((mal_p)gc)->as.function);
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.function);
       break;
     case MAL_CLOSURE:
-      lvm_gc_mark(this, (gc_p)((mal_p)gc)->as.closure);
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.closure);
+      break;
+    case MAL_LOCAL:
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.local);
+      break;
+    case MAL_LAMBDA:
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.lambda);
       break;
     case MAL_LIST:
-      lvm_gc_mark(this, (gc_p)((mal_p)gc)->as.list);
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.list);
       break;
     case MAL_VECTOR:
-      lvm_gc_mark(this, (gc_p)((mal_p)gc)->as.vector);
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.vector);
       break;
     case MAL_HASHMAP:
-      lvm_gc_mark(this, (gc_p)((mal_p)gc)->as.hashmap);
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.hashmap);
       break;
     case MAL_ENV:
-      lvm_gc_mark(this, (gc_p)((mal_p)gc)->as.env);
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.env);
       break;
     case MAL_ERROR:
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.error);
+      break;
+    case MAL_STRING:
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.string);
+      break;
+    case MAL_SYMBOL:
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.symbol);
+      break;
+    case MAL_KEYWORD:
+      lvm_gc_gray(this, (gc_p)((mal_p)gc)->as.keyword);
+      break;
     default:
       break;
     }
-    lvm_gc_mark(this, (gc_p)((mal_p)gc)->signature);
-    lvm_gc_mark(this, (gc_p)((mal_p)gc)->identity);
-    lvm_gc_mark(this, (gc_p)((mal_p)gc)->token);
     break;
   }
 }
 
 void lvm_gc_mark_all(lvm_p this)
 {
-  (void)this;
+  size_t at;
   lvm_gc_mark(this, (gc_p)this->env);
+  lvm_gc_mark(this, (gc_p)this->error);
+  lvm_gc_mark(this, (gc_p)this->comment);
+  for (at = 0; at < this->symbols.capacity; at++) {
+    if (this->symbols.data[at]) {
+      lvm_gc_mark(this, (gc_p)this->symbols.data[at]);
+    }
+  }
+  for (at = 0; at < this->roots.count; at++) {
+    lvm_gc_mark(this, this->roots.data[at]);
+  }
+  for (at = 0; at < this->values.count; at++) {
+    lvm_gc_mark(this, (gc_p)this->values.data[at]);
+  }
+  for (at = 0; at < this->frames.count; at++) {
+    lvm_gc_mark(this, (gc_p)this->frames.data[at].code);
+    lvm_gc_mark(this, (gc_p)this->frames.data[at].env);
+  }
+  for (at = 0; at < this->catches.count; at++) {
+    lvm_gc_mark(this, (gc_p)this->catches.data[at].frame.code);
+    lvm_gc_mark(this, (gc_p)this->catches.data[at].frame.env);
+  }
+  for (at = 0; at < this->envs.count; at++) {
+    lvm_gc_scan(this, (gc_p)this->envs.data[at]);
+    lvm_gc_drain(this);
+  }
+  if (!this->gc.major) {
+    for (at = 0; at < this->gc.remembered.count; at++) {
+      gc_p gc = this->gc.remembered.data[at];
+      gc->mark = GC_OLD;
+      lvm_gc_scan(this, gc);
+      lvm_gc_drain(this);
+    }
+  }
 }
 
 void lvm_gc_sweep(lvm_p this)
 {
-  gc_pp obj = &this->gc.first;
-  while (*obj) {
-    if (this->gc.mark != (*obj)->mark) {
-      gc_p unreached = (*obj);
-      (*obj) = unreached->next;
-      switch (unreached->type) {
-      case GC_TEXT:
-        text_free(this, unreached);
-        break;
-      case GC_FUNCTION:
-        function_free(this, unreached);
-        break;
-      case GC_CLOSURE:
-        closure_free(this, unreached);
-        break;
-      case GC_LIST:
-        list_free(this, unreached);
-        break;
-      case GC_VECTOR:
-        vector_free(this, unreached);
-        break;
-      case GC_HASHMAP:
-        hashmap_free(this, unreached);
-        break;
-      case GC_ENV:
-        env_free(this, unreached);
-        break;
-      case GC_ERROR:
-        error_free(this, unreached);
-        break;
-      case GC_COMMENT:
-        comment_free(this, unreached);
-        break;
-      case GC_TOKEN:
-        token_free(this, unreached);
-        break;
-      case GC_MAL:
-        mal_free(this, unreached);
-        break;
+  gc_pp obj;
+  gc_p gc;
+  if (this->gc.major) {
+    obj = &this->gc.old;
+    while (*obj) {
+      gc = (*obj);
+      if (GC_BLACK == gc->mark) {
+        gc->mark = GC_OLD;
+        obj = &gc->next;
+      } else if (GC_IMMORTAL == gc->mark) {
+        obj = &gc->next;
+      } else {
+        (*obj) = gc->next;
+        lvm_gc_release(this, gc);
+        this->gc.old_count--;
       }
-      this->gc.count--;
+    }
+  }
+  obj = &this->gc.first;
+  while (*obj) {
+    gc = (*obj);
+    (*obj) = gc->next;
+    if (GC_WHITE == gc->mark) {
+      lvm_gc_release(this, gc);
     } else {
-      obj = &(*obj)->next;
+      if (GC_BLACK == gc->mark) {
+        gc->mark = GC_OLD;
+      }
+      gc->next = this->gc.old;
+      this->gc.old = gc;
+      this->gc.old_count++;
     }
   }
+  this->gc.count = 0;
+}
+
+void lvm_gc_release(lvm_p this, gc_p gc)
+{
+  switch (gc->type) {
+  case GC_TEXT:
+    text_free(this, gc);
+    break;
+  case GC_FUNCTION:
+    function_free(this, gc);
+    break;
+  case GC_CLOSURE:
+    closure_free(this, gc);
+    break;
+  case GC_LAMBDA:
+    lambda_free(this, gc);
+    break;
+  case GC_CODE:
+    code_free(this, gc);
+    break;
+  case GC_LIST:
+    list_free(this, gc);
+    break;
+  case GC_VECTOR:
+    vector_free(this, gc);
+    break;
+  case GC_VECTOR_NODE:
+    vector_node_free(this, gc);
+    break;
+  case GC_HASHMAP:
+    hashmap_free(this, gc);
+    break;
+  case GC_HASHMAP_NODE:
+    hashmap_node_free(this, gc);
+    break;
+  case GC_ENV:
+    env_free(this, gc);
+    break;
+  case GC_ERROR:
+    error_free(this, gc);
+    break;
+  case GC_COMMENT:
+    comment_free(this, gc);
+    break;
+  case GC_TOKEN:
+    token_free(this, gc);
+    break;
+  case GC_MAL:
+    mal_free(this, gc);
+    break;
+  }
 }
 
 void lvm_gc_print(lvm_p this)
@@ -3240,52 +5238,27 @@ void lvm_gc_print(lvm_p this)
     case GC_CLOSURE:
       printf("closure: %s\n", closure_text(this, ((closure_p)gc)));
       break;
+    case GC_LAMBDA:
+      printf("lambda: %s\n",
+          mal_print(this, ((lambda_p)gc)->form, false)->data);
+      break;
     case GC_LIST:
-      printf("list: (");
-      if (((list_p)gc)->count) {
-        printf("%s", ((list_p)gc)->data[0]->identity->data);
-        for (at = 1; at < ((list_p)gc)->count - 1; at++) {
-          printf(" %s", ((list_p)gc)->data[at]->identity->data);
-        }
-        if (!is_nil(((list_p)gc)->data[at])) {
-          printf(" : %s", ((list_p)gc)->data[at]->identity->data);
-        }
-      }
-      printf(")\n");
+      printf("list: %s\n", list_text(this, (list_p)gc)->data);
       break;
     case GC_VECTOR:
-      printf("vector: [");
-      if (((vector_p)gc)->count) {
-        printf("%s", ((vector_p)gc)->data[0]->identity->data);
-        for (at = 1; at < ((vector_p)gc)->count - 1; at++) {
-          printf(" %s", ((vector_p)gc)->data[at]->identity->data);
-        }
-        if (!is_nil(((vector_p)gc)->data[at])) {
-          printf(" : %s", ((vector_p)gc)->data[at]->identity->data);
-        }
-      }
-      printf("]\n");
+      printf("vector: %s\n", vector_text(this, (vector_p)gc)->data);
       break;
     case GC_HASHMAP:
-      printf("hashmap: {");
-      if (((hashmap_p)gc)->count) {
-        printf("%s: %s", ((hashmap_p)gc)->data[0]->identity->data,
-            ((hashmap_p)gc)->data[1]->identity->data);
-        for (at = 2; at < ((hashmap_p)gc)->count; at += 2) {
-          printf(" %s: %s", ((hashmap_p)gc)->data[at]->identity->data,
-              ((hashmap_p)gc)->data[at + 1]->identity->data);
-        }
-      }
-      printf("}\n");
+      printf("hashmap: %s\n", hashmap_text(this, (hashmap_p)gc)->data);
       break;
     case GC_ENV:
       printf("env: {");
-      if (((env_p)gc)->hashmap->count) {
-        printf("%s: %s", ((env_p)gc)->hashmap->data[0]->identity->data,
-            ((env_p)gc)->hashmap->data[1]->identity->data);
-        for (at = 2; at < ((env_p)gc)->hashmap->count; at += 2) {
-          printf(" %s: %s", ((env_p)gc)->hashmap->data[at]->identity->data,
-              ((env_p)gc)->hashmap->data[at + 1]->identity->data);
+      if (((env_p)gc)->count) {
+        printf("%s: %s", mal_print(this, ((env_p)gc)->data[0], false)->data,
+            mal_print(this, ((env_p)gc)->data[1], false)->data);
+        for (at = 2; at < ((env_p)gc)->count; at += 2) {
+          printf(" %s: %s", mal_print(this, ((env_p)gc)->data[at], false)->data,
+              mal_print(this, ((env_p)gc)->data[at + 1], false)->data);
         }
       }
       printf("}\n");
@@ -3315,72 +5288,65 @@ void lvm_gc_print(lvm_p this)
 void lvm_gc(lvm_p this)
 {
 #if DEBUG
-  size_t count = this->gc.count;
+  size_t count = this->gc.count + this->gc.old_count;
 #endif
+  this->gc.major = this->gc.old_count >= this->gc.old_total;
   lvm_gc_mark_all(this);
+  if (this->positions.count) {
+    positions_rebuild(this, this->positions.capacity, true);
+  }
   lvm_gc_sweep(this);
-
-  this->gc.total = this->gc.count == 0 ? 8 : this->gc.count * 2;
-#if DEBUG
-  printf("Collected %lu objects, %lu remaining.\n", count - this->gc.count,
-      this->gc.count);
-#endif
-#if GC_ON
-  this->gc.mark = !this->gc.mark;
-#endif
+  this->gc.remembered.count = 0;
+  if (this->gc.major) {
+    this->gc.old_total = this->gc.old_count > GC_NURSERY ?
+        this->gc.old_count * 2 : GC_NURSERY;
+  }
+  this->gc.major = false;
 #if DEBUG
+  printf("Collected %lu objects, %lu remaining.\n",
+      count - this->gc.old_count, this->gc.old_count);
   lvm_gc_print(this);
 #endif
 }
 
 void lvm_gc_free(lvm_p this)
 {
-  gc_p gc = this->gc.first;
+  gc_p gc;
   gc_p tmp;
+  gc_pp obj = &this->gc.first;
+  while (*obj) {
+    obj = &(*obj)->next;
+  }
+  (*obj) = this->gc.old;
+  while (*obj) {
+    obj = &(*obj)->next;
+  }
+  (*obj) = this->gc.immortal;
+  this->gc.old = NULL;
+  this->gc.immortal = NULL;
+  gc = this->gc.first;
+  this->gc.first = NULL;
   while (gc) {
     tmp = gc;
     gc = gc->next;
-    switch (tmp->type) {
-    case GC_TEXT:
-      text_free(this, tmp);
-      break;
-    case GC_FUNCTION:
-      function_free(this, tmp);
-      break;
-    case GC_CLOSURE:
-      closure_free(this, tmp);
-      break;
-    case GC_LIST:
-      list_free(this, tmp);
-      break;
-    case GC_VECTOR:
-      vector_free(this, tmp);
-      break;
-    case GC_HASHMAP:
-      hashmap_free(this, tmp);
-      break;
-    case GC_ENV:
-      vector_free(this, tmp);
-      break;
-    case GC_ERROR:
-      error_free(this, tmp);
-      break;
-    case GC_COMMENT:
-      comment_free(this, tmp);
-      break;
-    case GC_TOKEN:
-      token_free(this, tmp);
-      break;
-    case GC_MAL:
-      mal_free(this, tmp);
-      break;
-    }
+    lvm_gc_release(this, tmp);
   }
 }
 
 void lvm_free(lvm_pp this)
 {
   lvm_gc_free(*this);
+  slab_destroy(*this);
+  symbols_free(*this);
+  positions_free(*this);
+  roots_free(*this);
+  values_free(*this);
+  frames_free(*this);
+  envs_free(*this);
+  catches_free(*this);
+  free((void *)(*this)->gc.gray.data);
+  free((void *)(*this)->gc.remembered.data);
+  free((void *)(*this)->constant.integer);
   free((void *)(*this));
   (*this) = NULL;
   return;
@@ -3390,12 +5356,16 @@ mal_p eval_ast(lvm_p this, mal_p ast, env_p env)
 {
   mal_p result;
   switch (ast->type) {
+  case MAL_LOCAL:
+    return env_local(this, env, ast);
+  case MAL_LAMBDA:
+    return eval_fn_star(this, ast, env);
   case MAL_SYMBOL:
     if (env_get(this, env, ast, &result)) {
       return result;
     } else {
 #if VAR_NIL
-      env_get_by_text(this, env, text_make(this, "nil: nil"), &result);
+      result = mal_nil(this);
       return result;
 #else
       return mal_error(this, ERROR_RUNTIME,
@@ -3436,31 +5406,52 @@ mal_p eval_ast(lvm_p this, mal_p ast, env_p env)
 mal_p eval_list(lvm_p this, list_p original, env_p env)
 {
   list_p evaluated = list_make(this, original->count);
+  size_t base = roots_push(this, (gc_p)evaluated);
   size_t at;
   for (at = 0; at < original->count; at++) {
-    list_append(this, evaluated, lvm_eval(this, original->data[at], env));
+    list_append(this, evaluated, eval_form(this, original->data[at], env));
+  }
+  if (original->tail) {
+    evaluated->tail = eval_form(this, original->tail, env);
   }
+  roots_pop(this, base);
   return mal_list(this, evaluated);
 }
 
 mal_p eval_vector(lvm_p this, vector_p original, env_p env)
 {
   vector_p evaluated = vector_make(this, original->count);
+  size_t base = roots_push(this, (gc_p)evaluated);
   size_t at;
+  mal_p value;
   for (at = 0; at < original->count; at++) {
-    vector_append(this, evaluated, lvm_eval(this, original->data[at], env));
+    value = eval_form(this, vector_get(this, original, at), env);
+    if (is_error(value)) {
+      /* only returns when no try* is waiting for it */
+      lvm_raise(this, value);
+    }
+    vector_append(this, evaluated, value);
   }
+  roots_pop(this, base);
   return mal_vector(this, evaluated);
 }
 
 mal_p eval_hashmap(lvm_p this, hashmap_p original, env_p env)
 {
   size_t at;
-  hashmap_p evaluated = hashmap_make(this, original->count >> 1);
-  for (at = 0; at < original->count; at += 2) {
-    hashmap_set(this, evaluated, original->data[at],
-        lvm_eval(this, original->data[at + 1], env));
+  hashmap_p evaluated = hashmap_copy(this, original);
+  list_p pairs = hashmap_list(this, original);
+  size_t base = roots_push(this, (gc_p)evaluated);
+  mal_p value;
+  roots_push(this, (gc_p)pairs);
+  for (at = 0; at < pairs->count; at += 2) {
+    value = eval_form(this, pairs->data[at + 1], env);
+    if (is_error(value)) {
+      lvm_raise(this, value);
+    }
+    hashmap_set(this, evaluated, pairs->data[at], value);
   }
+  roots_pop(this, base);
   return mal_hashmap(this, evaluated);
 }
 
@@ -3470,7 +5461,7 @@ mal_p eval_def_bang(lvm_p this, mal_p ast, env_p env)
   mal_p symbol;
   mal_p value;
   mal_p result;
-  if (2 > list->count || (2 < list->count && !is_nil(list->data[2]))) {
+  if (2 != list->count || list->tail) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'def!': expected proper list with two arguments\n"));
   }
@@ -3479,10 +5470,15 @@ mal_p eval_def_bang(lvm_p this, mal_p ast, env_p env)
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'def!': expected symbol as first argument\n"));
   }
-  value = list_params(this, list)->data[0];
-  result = lvm_eval(this, value, env);
+  value = list->data[1];
+  result = eval_form(this, value, env);
 
   if (!is_error(result)) {
+    env_shadow(this, env, symbol);
+    if (env != this->env && !env->shadow) {
+      env->shadow = true;
+      this->version++;
+    }
     env_set(this, env, symbol, result);
   }
   return result;
@@ -3493,21 +5489,23 @@ mal_p eval_let_star(lvm_p this, mal_p ast, env_pp outer)
   list_p bindings;
   env_p env;
   size_t at = 0;
+  size_t base;
   mal_p forms;
   mal_p nil;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
+  nil = mal_nil(this);
   if (2 > ast->as.list->count) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'let*': missing binding list\n"));
   }
-  forms = 2 <= ast->as.list->count ? ast->as.list->data[2] : nil;
+  forms = 2 < ast->as.list->count ? ast->as.list->data[2] : nil;
   if (!is_sequential(ast->as.list->data[1])) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'let*': first argument is not list or vector\n"));
   }
-  bindings = ast->as.list->data[1]->as.list;
-  if ((bindings->count % 2 == 0 && is_nil(bindings->data[bindings->count - 1])) || (
-      bindings->count % 2 == 1 && !is_nil(bindings->data[bindings->count - 1]))) {
+  bindings = is_vector(ast->as.list->data[1]) ?
+      vector_list(this, ast->as.list->data[1]->as.vector) :
+      ast->as.list->data[1]->as.list;
+  if (bindings->count % 2 == 1) {
 #if VAR_NIL
     list_append(this, bindings, nil);
 #else
@@ -3515,26 +5513,32 @@ mal_p eval_let_star(lvm_p this, mal_p ast, env_pp outer)
         "'let*': expected an even number of binding pairs\n"));
 #endif
   }
-  env = env_make(this, (*outer), NULL, NULL, NULL, 0);
-  if ((4 == ast->as.list->count && is_nil(ast->as.list->data[3])) ||
-      3 == ast->as.list->count) {
-    for (at = 0; at < bindings->count - 1; at += 2) {
+  env = env_make(this, (*outer), NULL, 0, NULL, NULL, bindings->count);
+  base = roots_push(this, (gc_p)bindings);
+  roots_push(this, (gc_p)env);
+  if (3 == ast->as.list->count && !ast->as.list->tail) {
+    for (at = 0; at < bindings->count; at += 2) {
       mal_p symbol = bindings->data[at];
-      mal_p value = lvm_eval(this, bindings->data[at + 1], env);
+      mal_p value = eval_form(this, bindings->data[at + 1], env);
       if (is_error(value)) {
+        roots_pop(this, base);
         return value;
       }
       if (!is_symbol(symbol)) {
+        roots_pop(this, base);
         return mal_error(this, ERROR_RUNTIME,
             text_concat(this, text_concat_text(this, text_make(this,
             "'let*': binding error, '"), mal_print(this, symbol, false)),
             "' is not a symbol\n"));
       }
+      env_shadow(this, env, symbol);
       env_set(this, env, symbol, value);
     }
+    roots_pop(this, base);
     (*outer) = env;
     return forms;
   }
+  roots_pop(this, base);
   return mal_error(this, ERROR_RUNTIME, text_make(this,
       "'let*': expected the proper list with exactly three elements\n"));
 }
@@ -3543,26 +5547,26 @@ mal_p eval_if(lvm_p this, mal_p ast, env_pp env)
 {
   list_p list = ast->as.list;
   mal_p condition;
-  if (list->count < 3 || (3 == list->count && is_nil(list->data[2]))) {
+  if (list->count < 3) {
     return mal_error(this, ERROR_RUNTIME, text_concat(this,
         text_concat_text(this, text_make(this, "'if': got too few arguments '"),
-        text_make_integer(this, list->count - 2)), "'\n"));
+        text_make_integer(this, list->count - 1)), "'\n"));
   }
-  if (list->count > 4 && !is_nil(list->data[4])) {
+  if (list->count > 4 || list->tail) {
     return mal_error(this, ERROR_RUNTIME, text_concat(this,
         text_concat_text(this, text_make(this, "'if': got too many arguments '"),
-        text_make_integer(this, list->count - 2)), "'\n"));
+        text_make_integer(this, list->count - 1)), "'\n"));
   }
-  condition = lvm_eval(this, list->data[1], *env);
+  condition = eval_form(this, list->data[1], *env);
   if (is_error(condition)) {
     return condition;
   }
   if (is_false(condition) || is_nil(condition)) {
-    if (!is_nil(list->data[3])) {
+    if (4 == list->count) {
       return list->data[3];
     } else {
       mal_p nil;
-      env_get_by_text(this, *env, text_make(this, "nil: nil"), &nil);
+      nil = mal_nil(this);
       return nil;
     }
   } else {
@@ -3572,35 +5576,12 @@ mal_p eval_if(lvm_p this, mal_p ast, env_pp env)
 
 mal_p eval_fn_star(lvm_p this, mal_p ast, env_p env)
 {
-  mal_p result;
-  mal_p params;
-  mal_p more = NULL;
-  mal_p definition;
-  list_p list = ast->as.list;
-  if (3 > list->count && is_nil(list->data[1])) {
-    return mal_error(this, ERROR_RUNTIME, text_concat(this,
-        text_concat_text(this, text_make(this, "'fn*': has too few arguments '"),
-        text_make_integer(this, list->count - 2)),
-        "' missing parameters and body\n"));
-  }
-  if (4 > list->count && is_nil(list->data[2])) {
-    return mal_error(this, ERROR_RUNTIME, text_concat(this,
-        text_concat_text(this, text_make(this, "'fn*': has too few arguments '"),
-        text_make_integer(this, list->count - 2)), "' missing body\n"));
+  mal_p lambda = is_lambda(ast) ? ast : closure_lambda(this, ast, NULL, NULL);
+  if (is_error(lambda)) {
+    return lambda;
   }
-  if (4 <= list->count && !is_nil(list->data[3])) {
-    return mal_error(this, ERROR_RUNTIME, text_concat(this,
-        text_concat_text(this, text_make(this,
-        "'fn*': has too many arguments '"),
-        text_make_integer(this, list->count - 2)), "'\n"));
-  }
-  params = list->data[1];
-  result = closure_parameters(this, &params, &more);
-  if (is_error(result)) {
-    return result;
-  }
-  definition = list->data[2];
-  return mal_closure(this, closure_make(this, env, params, definition, more));
+  return mal_closure(this, closure_make(this,
+      closure_env(this, env, lambda->as.lambda), lambda->as.lambda));
 }
 
 mal_p eval_do(lvm_p this, mal_p ast, env_p env)
@@ -3608,331 +5589,855 @@ mal_p eval_do(lvm_p this, mal_p ast, env_p env)
   list_p list = list_params(this, ast->as.list);
   mal_p mal;
   size_t at;
-  if (0 == list->count || (1 == list->count && is_nil(list->data[0]))) {
+  size_t base;
+  if (0 == list->count) {
     mal_p nil;
-    env_get_by_text(this, env, text_make(this, "nil: nil"), &nil);
+    nil = mal_nil(this);
     return nil;
   }
+  base = roots_push(this, (gc_p)list);
   for (at = 0; at < list->count - 1; at++) {
-    mal = lvm_eval(this, list->data[at], env);
+    mal = eval_form(this, list->data[at], env);
     if (is_error(mal)) {
+      roots_pop(this, base);
       return mal;
     }
   }
-  if (is_nil(list->data[at])) {
-    return mal;
-  } else {
-    return list->data[at];
-  }
+  roots_pop(this, base);
+  return list->data[at];
 }
 
-mal_p core_add(lvm_p this, mal_p args)
+code_p compile(lvm_p this, mal_p ast)
 {
-  mal_type type = MAL_INTEGER;
-  list_p arg_list = args->as.list;
-  union {
-    long integer;
-    double decimal;
-  } sum;
-  mal_p result = mal_integer(this, 0);
-  if (0 == arg_list->count || (is_nil(arg_list->data[0]) &&
-      1 == arg_list->count)) {
-    return result;
+  code_p code = code_make(this);
+  size_t base = roots_push(this, (gc_p)code);
+  code->stack = !closure_escapes(this, ast);
+  compile_form(this, code, ast, true);
+  if (code->error) {
+    /* the form is rejected as a whole, before any of it runs, and the
+     * tree walker reports the offending form each time it is run */
+    code->count = 0;
+    code_emit(this, code, op_eval, 0, code->error);
+    code->error = NULL;
   }
-  switch (arg_list->data[0]->type) {
-  case MAL_INTEGER:
-    result->as.integer = arg_list->data[0]->as.integer;
-    break;
-  case MAL_DECIMAL:
-    result->type = type = MAL_DECIMAL;
-    result->as.decimal = arg_list->data[0]->as.decimal;
-    break;
+  code_emit(this, code, op_return, 0, NULL);
+  roots_pop(this, base);
+  return code;
+}
+
+void compile_form(lvm_p this, code_p code, mal_p ast, bool tail)
+{
+  list_p list;
+  switch (ast->type) {
+  case MAL_SYMBOL:
+    code_emit(this, code, op_symbol, 0, ast);
+    return;
+  case MAL_LOCAL:
+    code_emit(this, code, op_local, 0, ast);
+    return;
+  case MAL_LAMBDA:
+    code_emit(this, code, op_closure, 0, ast);
+    return;
+  case MAL_VECTOR:
+    compile_vector(this, code, ast);
+    return;
+  case MAL_HASHMAP:
+    compile_hashmap(this, code, ast);
+    return;
+  case MAL_LIST:
+    list = ast->as.list;
+    if (0 == list->count) {
+      break;
+    }
+    switch (list->data[0]->special) {
+    case SPECIAL_DEF_BANG:
+      if (compile_def_bang(this, code, ast, tail)) {
+        return;
+      }
+      break;
+    case SPECIAL_LET_STAR:
+      if (compile_let_star(this, code, ast, tail)) {
+        return;
+      }
+      break;
+    case SPECIAL_IF:
+      if (compile_if(this, code, ast, tail)) {
+        return;
+      }
+      break;
+    case SPECIAL_FN_STAR:
+      compile_fn_star(this, code, ast);
+      return;
+    case SPECIAL_DO:
+      compile_do(this, code, ast, tail);
+      return;
+    case SPECIAL_ENV:
+      code_emit(this, code, op_env, 0, NULL);
+      return;
+    case SPECIAL_TRY_STAR:
+      if (compile_try_star(this, code, ast, tail)) {
+        return;
+      }
+      break;
+    case SPECIAL_LOOP:
+      if (compile_loop(this, code, ast, tail)) {
+        return;
+      }
+      break;
+    case SPECIAL_RECUR:
+      if (!compile_recur(this, code, ast) && NULL == code->error) {
+        code->error = ast;
+      }
+      return;
+    case SPECIAL_NONE:
+    default:
+      compile_call(this, code, ast, tail);
+      return;
+    }
+    /* malformed special form, the tree walker reports the error */
+    code_emit(this, code, op_eval, 0, ast);
+    return;
   default:
-    return mal_error(this, ERROR_RUNTIME,
-        text_concat(this, text_concat_text(this, text_make(this,
-        "args to '+' are not numbers '"), mal_print(this,
-        args->as.list->data[0], false)), "'\n"));
+    break;
   }
+  code_emit(this, code, op_constant, 0, ast);
+}
 
-  if (1 < arg_list->count) {
-    size_t at;
+void compile_value(lvm_p this, code_p code, mal_p ast)
+{
+  bool active = code->loop.active;
+  code->loop.active = false;
+  compile_form(this, code, ast, false);
+  code->loop.active = active;
+}
 
-    for (at = 1; at < arg_list->count; at++) {
-      if (at == arg_list->count - 1 && is_nil(arg_list->data[at])) {
-        break;
-      }
-      if (is_integer(arg_list->data[at])) {
-        if (MAL_INTEGER == type) {
-          sum.integer = result->as.integer + arg_list->data[at]->as.integer;
-          result->as.integer = sum.integer;
-        } else if (MAL_DECIMAL == type) {
-          sum.decimal = result->as.decimal +
-              (double)arg_list->data[at]->as.integer;
-          result->type = MAL_DECIMAL;
-          result->as.decimal = sum.decimal;
+bool compile_def_bang(lvm_p this, code_p code, mal_p ast, bool tail)
+{
+  list_p list = ast->as.list;
+  (void)tail;
+  if (3 != list->count || list->tail || !is_symbol(list->data[1])) {
+    return false;
+  }
+  compile_value(this, code, list->data[2]);
+  code_emit(this, code, op_def, 0, list->data[1]);
+  return true;
+}
+
+void compile_fn_star(lvm_p this, code_p code, mal_p ast)
+{
+  /* a malformed fn* reports its error when it is evaluated */
+  size_t errors = this->error ? this->error->count : 0;
+  mal_p lambda = closure_lambda(this, ast, code->scope, code->defined);
+  if (is_error(lambda)) {
+    this->error->count = errors;
+    lambda = ast;
+  }
+  code_emit(this, code, op_closure, 0, lambda);
+}
+
+/* names the frame a let* or loop binds while its values and body are
+ * compiled, for the fn* forms among them to resolve against. the
+ * outermost one also collects the symbols a def! may bind in them */
+void compile_scope(lvm_p this, code_p code, scope_p scope, mal_p ast,
+    list_p bindings)
+{
+  size_t at;
+  if (NULL == code->scope) {
+    code->defined = list_make(this, 0);
+    closure_defined(this, ast, code->defined);
+  }
+  scope->symbols = list_make(this, bindings->count >> 1);
+  for (at = 0; at < bindings->count; at += 2) {
+    if (!list_find(this, scope->symbols, bindings->data[at])) {
+      list_append(this, scope->symbols, bindings->data[at]);
+    }
+  }
+  scope->bindings = bindings;
+  scope->next = 0;
+  scope->outer = code->scope;
+  code->scope = scope;
+}
+
+bool compile_let_star(lvm_p this, code_p code, mal_p ast, bool tail)
+{
+  list_p list = ast->as.list;
+  list_p bindings;
+  scope_t scope;
+  size_t at;
+  if (3 != list->count || list->tail || !is_sequential(list->data[1])) {
+    return false;
+  }
+  bindings = is_vector(list->data[1]) ?
+      vector_list(this, list->data[1]->as.vector) : list->data[1]->as.list;
+  if (bindings->count % 2 == 1) {
+    return false;
+  }
+  for (at = 0; at < bindings->count; at += 2) {
+    if (!is_symbol(bindings->data[at])) {
+      return false;
+    }
+  }
+  compile_scope(this, code, &scope, ast, bindings);
+  code_emit(this, code, closure_escapes(this, ast) ? op_let : op_let_stack,
+      bindings->count, NULL);
+  for (at = 0; at < bindings->count; at += 2) {
+    scope.next = at;
+    compile_value(this, code, bindings->data[at + 1]);
+    code_emit(this, code, op_bind, 0, bindings->data[at]);
+  }
+  scope.bindings = NULL;
+  code->loop.depth++;
+  compile_form(this, code, list->data[2], tail);
+  code->loop.depth--;
+  code->scope = scope.outer;
+  if (NULL == code->scope) {
+    code->defined = NULL;
+  }
+  if (!tail) {
+    code_emit(this, code, op_unlet, 0, NULL);
+  }
+  return true;
+}
+
+list_p compile_loop_bindings(lvm_p this, mal_p ast)
+{
+  list_p list = ast->as.list;
+  list_p bindings;
+  size_t at;
+  if (3 != list->count || list->tail || !is_sequential(list->data[1])) {
+    return NULL;
+  }
+  bindings = is_vector(list->data[1]) ?
+      vector_list(this, list->data[1]->as.vector) : list->data[1]->as.list;
+  if (bindings->count % 2 == 1 || (bindings->count >> 1) > LOCAL_MASK) {
+    return NULL;
+  }
+  for (at = 0; at < bindings->count; at += 2) {
+    size_t in;
+    if (!is_symbol(bindings->data[at])) {
+      return NULL;
+    }
+    for (in = 0; in < at; in += 2) {
+      if (bindings->data[in] == bindings->data[at]) {
+        return NULL;
+      }
+    }
+  }
+  return bindings;
+}
+
+bool compile_loop(lvm_p this, code_p code, mal_p ast, bool tail)
+{
+  list_p bindings = compile_loop_bindings(this, ast);
+  scope_t scope;
+  size_t at;
+  bool active;
+  bool fresh;
+  size_t start;
+  size_t count;
+  size_t depth;
+  if (!bindings) {
+    return false;
+  }
+  compile_scope(this, code, &scope, ast, bindings);
+  code_emit(this, code, closure_escapes(this, ast) ? op_let : op_let_stack,
+      bindings->count, NULL);
+  for (at = 0; at < bindings->count; at += 2) {
+    scope.next = at;
+    compile_value(this, code, bindings->data[at + 1]);
+    code_emit(this, code, op_bind, 0, bindings->data[at]);
+  }
+  scope.bindings = NULL;
+  active = code->loop.active;
+  fresh = code->loop.fresh;
+  start = code->loop.start;
+  count = code->loop.count;
+  depth = code->loop.depth;
+  code->loop.active = true;
+  code->loop.fresh = closure_escapes(this, ast->as.list->data[2]);
+  code->loop.start = code->count;
+  code->loop.count = bindings->count >> 1;
+  code->loop.depth = 0;
+  compile_form(this, code, ast->as.list->data[2], tail);
+  code->loop.active = active;
+  code->loop.fresh = fresh;
+  code->loop.start = start;
+  code->loop.count = count;
+  code->loop.depth = depth;
+  code->scope = scope.outer;
+  if (NULL == code->scope) {
+    code->defined = NULL;
+  }
+  if (!tail) {
+    code_emit(this, code, op_unlet, 0, NULL);
+  }
+  return true;
+}
+
+bool compile_recur(lvm_p this, code_p code, mal_p ast)
+{
+  list_p list = ast->as.list;
+  size_t at;
+  if (!code->loop.active || list->tail ||
+      list->count - 1 != code->loop.count || code->loop.depth > LOCAL_MASK) {
+    return false;
+  }
+  for (at = 1; at < list->count; at++) {
+    compile_value(this, code, list->data[at]);
+  }
+  code_emit(this, code, code->loop.fresh ? op_recur_fresh : op_recur,
+      (code->loop.depth << LOCAL_BITS) | code->loop.count, NULL);
+  code_emit(this, code, op_jump, code->loop.start, NULL);
+  return true;
+}
+
+bool compile_if(lvm_p this, code_p code, mal_p ast, bool tail)
+{
+  list_p list = ast->as.list;
+  size_t otherwise;
+  size_t end;
+  if (list->count < 3 || list->count > 4 || list->tail) {
+    return false;
+  }
+  compile_value(this, code, list->data[1]);
+  otherwise = code_emit(this, code, op_jump_false, 0, NULL);
+  compile_form(this, code, list->data[2], tail);
+  end = code_emit(this, code, op_jump, 0, NULL);
+  code_patch(this, code, otherwise);
+  compile_form(this, code, 4 == list->count ? list->data[3] : mal_nil(this),
+      tail);
+  code_patch(this, code, end);
+  return true;
+}
+
+void compile_do(lvm_p this, code_p code, mal_p ast, bool tail)
+{
+  list_p list = ast->as.list;
+  size_t at;
+  if (1 == list->count) {
+    compile_form(this, code, mal_nil(this), tail);
+    return;
+  }
+  for (at = 1; at < list->count - 1; at++) {
+    compile_value(this, code, list->data[at]);
+    code_emit(this, code, op_pop, 0, NULL);
+  }
+  compile_form(this, code, list->data[at], tail);
+}
+
+/* the body runs between op_try and op_untry, an error raised in it
+ * resumes at the catch* with the message bound like a one name let* */
+bool compile_try_star(lvm_p this, code_p code, mal_p ast, bool tail)
+{
+  list_p list = ast->as.list;
+  list_p clause;
+  list_p bindings;
+  scope_t scope;
+  size_t handler;
+  size_t end;
+  if (2 > list->count || 3 < list->count || list->tail) {
+    return false;
+  }
+  if (2 == list->count) {
+    compile_form(this, code, list->data[1], tail);
+    return true;
+  }
+  clause = is_list(list->data[2]) ? list->data[2]->as.list : NULL;
+  if (!clause || 3 != clause->count || clause->tail ||
+      SPECIAL_CATCH_STAR != clause->data[0]->special ||
+      !is_symbol(clause->data[1])) {
+    return false;
+  }
+  handler = code_emit(this, code, op_try, 0, NULL);
+  compile_value(this, code, list->data[1]);
+  code_emit(this, code, op_untry, 0, NULL);
+  end = code_emit(this, code, op_jump, 0, NULL);
+  code_patch(this, code, handler);
+  bindings = list_make(this, 2);
+  list_append(this, bindings, clause->data[1]);
+  list_append(this, bindings, clause->data[1]);
+  compile_scope(this, code, &scope, ast, bindings);
+  code_emit(this, code, closure_escapes(this, list->data[2]) ?
+      op_let : op_let_stack, bindings->count, NULL);
+  code_emit(this, code, op_bind, 0, clause->data[1]);
+  scope.bindings = NULL;
+  code->loop.depth++;
+  compile_form(this, code, clause->data[2], tail);
+  code->loop.depth--;
+  code->scope = scope.outer;
+  if (NULL == code->scope) {
+    code->defined = NULL;
+  }
+  if (!tail) {
+    code_emit(this, code, op_unlet, 0, NULL);
+  }
+  code_patch(this, code, end);
+  return true;
+}
+
+void compile_call(lvm_p this, code_p code, mal_p ast, bool tail)
+{
+  list_p list = ast->as.list;
+  size_t at;
+  for (at = 0; at < list->count; at++) {
+    compile_value(this, code, list->data[at]);
+  }
+  if (list->tail) {
+    compile_value(this, code, list->tail);
+  }
+  code_emit(this, code, tail ? op_tail_call : op_call,
+      list->count - (list->tail ? 0 : 1), ast);
+}
+
+void compile_vector(lvm_p this, code_p code, mal_p ast)
+{
+  vector_p vector = ast->as.vector;
+  size_t at;
+  for (at = 0; at < vector->count; at++) {
+    compile_value(this, code, vector_get(this, vector, at));
+  }
+  code_emit(this, code, op_vector, vector->count, NULL);
+}
+
+/* keys of a literal are not evaluated, they are pushed as constants */
+void compile_hashmap(lvm_p this, code_p code, mal_p ast)
+{
+  list_p pairs = hashmap_list(this, ast->as.hashmap);
+  size_t at;
+  for (at = 0; at < pairs->count; at += 2) {
+    code_emit(this, code, op_constant, 0, pairs->data[at]);
+    compile_value(this, code, pairs->data[at + 1]);
+  }
+  code_emit(this, code, op_hashmap, pairs->count >> 1, NULL);
+}
+
+bool integer_add(long a, long b, long *result)
+{
+  if ((b > 0 && a > LONG_MAX - b) || (b < 0 && a < LONG_MIN - b)) {
+    return false;
+  }
+  *result = a + b;
+  return true;
+}
+
+bool integer_sub(long a, long b, long *result)
+{
+  if ((b < 0 && a > LONG_MAX + b) || (b > 0 && a < LONG_MIN + b)) {
+    return false;
+  }
+  *result = a - b;
+  return true;
+}
+
+bool integer_mul(long a, long b, long *result)
+{
+  if (a > 0 ? (b > 0 ? a > LONG_MAX / b : b < LONG_MIN / a)
+      : (b > 0 ? a < LONG_MIN / b : (0 != a && b < LONG_MAX / a))) {
+    return false;
+  }
+  *result = a * b;
+  return true;
+}
+
+mal_p integer_overflow(lvm_p this, char *operator)
+{
+  return mal_error(this, ERROR_RUNTIME, text_concat(this,
+      text_concat(this, text_make(this, "'"), operator),
+      "': integer overflow\n"));
+}
+
+mal_p eval_try_star(lvm_p this, mal_p ast, env_p env)
+{
+  list_p list = ast->as.list;
+  list_p clause = NULL;
+  handler_t handler;
+  env_p scope;
+  text_p message;
+  mal_p value;
+  if (2 > list->count || 3 < list->count || list->tail) {
+    return mal_error(this, ERROR_RUNTIME, text_make(this,
+        "'try*': expected an expression and an optional catch* clause\n"));
+  }
+  if (3 == list->count) {
+    clause = is_list(list->data[2]) ? list->data[2]->as.list : NULL;
+    if (!clause || 3 != clause->count || clause->tail ||
+        SPECIAL_CATCH_STAR != clause->data[0]->special ||
+        !is_symbol(clause->data[1])) {
+      return mal_error(this, ERROR_RUNTIME, text_make(this,
+          "'catch*': expected a symbol and a handler expression\n"));
+    }
+  }
+  value = lvm_try(this, &handler, list->data[1], env);
+  if (!clause || !is_error(value)) {
+    return value;
+  }
+  if (this->error) {
+    this->error->count = handler.errors;
+  }
+  /* bind the message, an error value would be raised again when loaded */
+  message = text_make(this, value->as.error->data);
+  if (message->count && '\n' == message->data[message->count - 1]) {
+    message->data[--message->count] = 0x00;
+  }
+  scope = env_make(this, env, NULL, 0, NULL, NULL, 2);
+  env_set(this, scope, clause->data[1], mal_string(this, message));
+  return lvm_eval(this, clause->data[2], scope);
+}
+
+mal_p eval_loop_form(lvm_p this, mal_p ast, env_p env)
+{
+  if (!compile_loop_bindings(this, ast)) {
+    return mal_error(this, ERROR_RUNTIME, text_make(this,
+        "'loop': expected a binding list of distinct symbols and a body\n"));
+  }
+  return lvm_eval(this, ast, env);
+}
+
+mal_p eval_recur_form(lvm_p this, mal_p ast, env_p env)
+{
+  (void)ast;
+  (void)env;
+  return mal_error(this, ERROR_RUNTIME, text_make(this,
+      "'recur': expected in tail position of a loop with one argument "
+      "per binding\n"));
+}
+
+mal_p core_add(lvm_p this, size_t argc, mal_pp argv)
+{
+  mal_type type = MAL_INTEGER;
+  union {
+    long integer;
+    double decimal;
+  } sum;
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    if (!integer_add(argv[0]->as.integer, argv[1]->as.integer, &sum.integer)) {
+      return integer_overflow(this, "+");
+    }
+    return mal_integer(this, sum.integer);
+  }
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return mal_decimal(this, argv[0]->as.decimal + argv[1]->as.decimal);
+  }
+  sum.integer = 0;
+  if (0 == argc) {
+    return mal_integer(this, sum.integer);
+  }
+  switch (argv[0]->type) {
+  case MAL_INTEGER:
+    sum.integer = argv[0]->as.integer;
+    break;
+  case MAL_DECIMAL:
+    type = MAL_DECIMAL;
+    sum.decimal = argv[0]->as.decimal;
+    break;
+  default:
+    return mal_error(this, ERROR_RUNTIME,
+        text_concat(this, text_concat_text(this, text_make(this,
+        "args to '+' are not numbers '"), mal_print(this,
+        argv[0], false)), "'\n"));
+  }
+
+  if (1 < argc) {
+    size_t at;
+
+    for (at = 1; at < argc; at++) {
+      if (is_integer(argv[at])) {
+        if (MAL_INTEGER == type) {
+          if (!integer_add(sum.integer, argv[at]->as.integer, &sum.integer)) {
+            return integer_overflow(this, "+");
+          }
+        } else if (MAL_DECIMAL == type) {
+          sum.decimal = sum.decimal +
+              (double)argv[at]->as.integer;
         }
-      } else if (is_decimal(arg_list->data[at])) {
+      } else if (is_decimal(argv[at])) {
         if (MAL_INTEGER == type) {
-          sum.decimal = (double)result->as.integer +
-              arg_list->data[at]->as.decimal;
-          result->type = type = MAL_DECIMAL;
+          type = MAL_DECIMAL;
+          sum.decimal = (double)sum.integer +
+              argv[at]->as.decimal;
         } else if (MAL_DECIMAL == type) {
-          sum.decimal = result->as.decimal + arg_list->data[at]->as.decimal;
+          sum.decimal = sum.decimal + argv[at]->as.decimal;
         }
-        result->as.decimal = sum.decimal;
       } else {
         return mal_error(this, ERROR_RUNTIME,
             text_concat(this, text_concat_text(this, text_make(this,
             "args to '+' are not numbers '"), mal_print(this,
-            args->as.list->data[at], false)), "'\n"));
+            argv[at], false)), "'\n"));
       }
     }
   }
   switch (type) {
   case MAL_INTEGER:
+    return mal_integer(this, sum.integer);
   case MAL_DECIMAL:
-    return result;
+    return mal_decimal(this, sum.decimal);
   default:
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "unknown type of '+' result\n"));
   }
 }
 
-mal_p core_sub(lvm_p this, mal_p args)
+mal_p core_sub(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_type type = MAL_INTEGER;
-  list_p arg_list = args->as.list;
   union {
     long integer;
     double decimal;
   } difference;
-  mal_p result = mal_integer(this, 0);
-  if (0 == arg_list->count || (is_nil(arg_list->data[0]) &&
-      1 == arg_list->count)) {
-    return result;
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    if (!integer_sub(argv[0]->as.integer, argv[1]->as.integer,
+        &difference.integer)) {
+      return integer_overflow(this, "-");
+    }
+    return mal_integer(this, difference.integer);
   }
-  switch (arg_list->data[0]->type) {
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return mal_decimal(this, argv[0]->as.decimal - argv[1]->as.decimal);
+  }
+  difference.integer = 0;
+  if (0 == argc) {
+    return mal_integer(this, difference.integer);
+  }
+  switch (argv[0]->type) {
   case MAL_INTEGER:
-    result->as.integer = arg_list->data[0]->as.integer;
+    difference.integer = argv[0]->as.integer;
     break;
   case MAL_DECIMAL:
-    result->type = type = MAL_DECIMAL;
-    result->as.decimal = arg_list->data[0]->as.decimal;
+    type = MAL_DECIMAL;
+    difference.decimal = argv[0]->as.decimal;
     break;
   default:
     return mal_error(this, ERROR_RUNTIME,
         text_concat(this, text_concat_text(this, text_make(this,
         "args to '-' are not numbers '"), mal_print(this,
-        args->as.list->data[0], false)), "'\n"));
+        argv[0], false)), "'\n"));
   }
 
-  if (1 < arg_list->count) {
+  if (1 < argc) {
     size_t at;
 
-    for (at = 1; at < arg_list->count; at++) {
-      if (at == arg_list->count - 1 && is_nil(arg_list->data[at])) {
-        break;
-      }
-      if (is_integer(arg_list->data[at])) {
+    for (at = 1; at < argc; at++) {
+      if (is_integer(argv[at])) {
         if (MAL_INTEGER == type) {
-          difference.integer = result->as.integer -
-              arg_list->data[at]->as.integer;
-          result->as.integer = difference.integer;
+          if (!integer_sub(difference.integer, argv[at]->as.integer,
+              &difference.integer)) {
+            return integer_overflow(this, "-");
+          }
         } else if (MAL_DECIMAL == type) {
-          difference.decimal = result->as.decimal -
-              (double)arg_list->data[at]->as.integer;
-          result->type = MAL_DECIMAL;
-          result->as.decimal = difference.decimal;
+          difference.decimal = difference.decimal -
+              (double)argv[at]->as.integer;
         }
-      } else if (is_decimal(arg_list->data[at])) {
+      } else if (is_decimal(argv[at])) {
         if (MAL_INTEGER == type) {
-          difference.decimal = (double)result->as.integer -
-              arg_list->data[at]->as.decimal;
-          result->type = type = MAL_DECIMAL;
+          type = MAL_DECIMAL;
+          difference.decimal = (double)difference.integer -
+              argv[at]->as.decimal;
         } else if (MAL_DECIMAL == type) {
-          difference.decimal = result->as.decimal -
-              arg_list->data[at]->as.decimal;
+          difference.decimal = difference.decimal -
+              argv[at]->as.decimal;
         }
-        result->as.decimal = difference.decimal;
       } else {
         return mal_error(this, ERROR_RUNTIME,
             text_concat(this, text_concat_text(this, text_make(this,
             "args to '-' are not numbers '"), mal_print(this,
-            args->as.list->data[at], false)), "'\n"));
+            argv[at], false)), "'\n"));
       }
     }
   }
   switch (type) {
   case MAL_INTEGER:
+    return mal_integer(this, difference.integer);
   case MAL_DECIMAL:
-    return result;
+    return mal_decimal(this, difference.decimal);
   default:
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "unknown type of '-' result\n"));
   }
 }
 
-mal_p core_mul(lvm_p this, mal_p args)
+mal_p core_mul(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_type type = MAL_INTEGER;
-  list_p arg_list = args->as.list;
   union {
     long integer;
     double decimal;
   } product;
-  mal_p result = mal_integer(this, 1);
-  if (0 == arg_list->count || (is_nil(arg_list->data[0]) &&
-      1 == arg_list->count)) {
-    return result;
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    if (!integer_mul(argv[0]->as.integer, argv[1]->as.integer,
+        &product.integer)) {
+      return integer_overflow(this, "*");
+    }
+    return mal_integer(this, product.integer);
   }
-  switch (arg_list->data[0]->type) {
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return mal_decimal(this, argv[0]->as.decimal * argv[1]->as.decimal);
+  }
+  product.integer = 1;
+  if (0 == argc) {
+    return mal_integer(this, product.integer);
+  }
+  switch (argv[0]->type) {
   case MAL_INTEGER:
-    result->as.integer = arg_list->data[0]->as.integer;
+    product.integer = argv[0]->as.integer;
     break;
   case MAL_DECIMAL:
-    result->type = type = MAL_DECIMAL;
-    result->as.decimal = arg_list->data[0]->as.decimal;
+    type = MAL_DECIMAL;
+    product.decimal = argv[0]->as.decimal;
     break;
   default:
     return mal_error(this, ERROR_RUNTIME,
         text_concat(this, text_concat_text(this, text_make(this,
         "args to '*' are not numbers '"), mal_print(this,
-        args->as.list->data[0], false)), "'\n"));
+        argv[0], false)), "'\n"));
   }
 
-  if (1 < arg_list->count) {
+  if (1 < argc) {
     size_t at;
 
-    for (at = 1; at < arg_list->count; at++) {
-      if (at == arg_list->count - 1 && is_nil(arg_list->data[at])) {
-        break;
-      }
-      if (is_integer(arg_list->data[at])) {
+    for (at = 1; at < argc; at++) {
+      if (is_integer(argv[at])) {
         if (MAL_INTEGER == type) {
-          product.integer = result->as.integer * arg_list->data[at]->as.integer;
-          result->as.integer = product.integer;
+          if (!integer_mul(product.integer, argv[at]->as.integer,
+              &product.integer)) {
+            return integer_overflow(this, "*");
+          }
         } else if (MAL_DECIMAL == type) {
-          product.decimal = result->as.decimal *
-              (double)arg_list->data[at]->as.integer;
-          result->type = MAL_DECIMAL;
-          result->as.decimal = product.decimal;
+          product.decimal = product.decimal *
+              (double)argv[at]->as.integer;
         }
-      } else if (is_decimal(arg_list->data[at])) {
+      } else if (is_decimal(argv[at])) {
         if (MAL_INTEGER == type) {
-          product.decimal = (double)result->as.integer *
-              arg_list->data[at]->as.decimal;
-          result->type = type = MAL_DECIMAL;
+          type = MAL_DECIMAL;
+          product.decimal = (double)product.integer *
+              argv[at]->as.decimal;
         } else if (MAL_DECIMAL == type) {
-          product.decimal = result->as.decimal * arg_list->data[at]->as.decimal;
+          product.decimal = product.decimal * argv[at]->as.decimal;
         }
-        result->as.decimal = product.decimal;
       } else {
         return mal_error(this, ERROR_RUNTIME,
             text_concat(this, text_concat_text(this, text_make(this,
             "args to '*' are not numbers '"), mal_print(this,
-            args->as.list->data[at], false)), "'\n"));
+            argv[at], false)), "'\n"));
       }
     }
   }
   switch (type) {
   case MAL_INTEGER:
+    return mal_integer(this, product.integer);
   case MAL_DECIMAL:
-    return result;
+    return mal_decimal(this, product.decimal);
   default:
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "unknown type of '*' result\n"));
   }
 }
 
-mal_p core_div(lvm_p this, mal_p args)
+mal_p core_div(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_type type = MAL_INTEGER;
-  list_p arg_list = args->as.list;
   union {
     long integer;
     double decimal;
   } quotient;
-  mal_p result = mal_integer(this, 1);
-  if (0 == arg_list->count || (is_nil(arg_list->data[0]) &&
-      1 == arg_list->count)) {
-    return result;
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    if (0 == argv[1]->as.integer) {
+      return mal_error(this, ERROR_RUNTIME, text_make(this,
+          "'/': division by zero\n"));
+    }
+    if (LONG_MIN == argv[0]->as.integer && -1 == argv[1]->as.integer) {
+      return integer_overflow(this, "/");
+    }
+    return mal_integer(this, argv[0]->as.integer / argv[1]->as.integer);
+  }
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return mal_decimal(this, argv[0]->as.decimal / argv[1]->as.decimal);
+  }
+  quotient.integer = 1;
+  if (0 == argc) {
+    return mal_integer(this, quotient.integer);
   }
-  switch (arg_list->data[0]->type) {
+  switch (argv[0]->type) {
   case MAL_INTEGER:
-    result->as.integer = arg_list->data[0]->as.integer;
+    quotient.integer = argv[0]->as.integer;
     break;
   case MAL_DECIMAL:
-    result->type = type = MAL_DECIMAL;
-    result->as.decimal = arg_list->data[0]->as.decimal;
+    type = MAL_DECIMAL;
+    quotient.decimal = argv[0]->as.decimal;
     break;
   default:
     return mal_error(this, ERROR_RUNTIME,
         text_concat(this, text_concat_text(this, text_make(this,
         "args to '/' are not numbers '"), mal_print(this,
-        args->as.list->data[0], false)), "'\n"));
+        argv[0], false)), "'\n"));
   }
 
-  if (1 < arg_list->count) {
+  if (1 < argc) {
     size_t at;
 
-    for (at = 1; at < arg_list->count; at++) {
-      if (at == arg_list->count - 1 && is_nil(arg_list->data[at])) {
-        break;
-      }
-      if (is_integer(arg_list->data[at])) {
+    for (at = 1; at < argc; at++) {
+      if (is_integer(argv[at])) {
         if (MAL_INTEGER == type) {
-          quotient.integer = result->as.integer /
-              arg_list->data[at]->as.integer;
-          result->as.integer = quotient.integer;
+          if (0 == argv[at]->as.integer) {
+            return mal_error(this, ERROR_RUNTIME, text_make(this,
+                "'/': division by zero\n"));
+          }
+          if (LONG_MIN == quotient.integer && -1 == argv[at]->as.integer) {
+            return integer_overflow(this, "/");
+          }
+          quotient.integer = quotient.integer / argv[at]->as.integer;
         } else if (MAL_DECIMAL == type) {
-          quotient.decimal = result->as.decimal /
-              (double)arg_list->data[at]->as.integer;
-          result->type = MAL_DECIMAL;
-          result->as.decimal = quotient.decimal;
+          quotient.decimal = quotient.decimal /
+              (double)argv[at]->as.integer;
         }
-      } else if (is_decimal(arg_list->data[at])) {
+      } else if (is_decimal(argv[at])) {
         if (MAL_INTEGER == type) {
-          quotient.decimal = (double)result->as.integer /
-              arg_list->data[at]->as.decimal;
-          result->type = type = MAL_DECIMAL;
+          type = MAL_DECIMAL;
+          quotient.decimal = (double)quotient.integer /
+              argv[at]->as.decimal;
         } else if (MAL_DECIMAL == type) {
-          quotient.decimal = result->as.decimal /
-              arg_list->data[at]->as.decimal;
+          quotient.decimal = quotient.decimal / argv[at]->as.decimal;
         }
-        result->as.decimal = quotient.decimal;
       } else {
         return mal_error(this, ERROR_RUNTIME,
             text_concat(this, text_concat_text(this, text_make(this,
             "args to '/' are not numbers '"), mal_print(this,
-            args->as.list->data[at], false)), "'\n"));
+            argv[at], false)), "'\n"));
       }
     }
   }
   switch (type) {
   case MAL_INTEGER:
+    return mal_integer(this, quotient.integer);
   case MAL_DECIMAL:
-    return result;
+    return mal_decimal(this, quotient.decimal);
   default:
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "unknown type of '/' result\n"));
   }
 }
 
-mal_p core_eq(lvm_p this, mal_p args)
+mal_p core_eq(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_p first;
   mal_p second;
   mal_p t;
   mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);      
-  if (2 > args->as.list->count || (2 < args->as.list->count &&
-      !is_nil(args->as.list->data[2]))) {
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    return this->constant.boolean[argv[0]->as.integer ==
+        argv[1]->as.integer];
+  }
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return this->constant.boolean[argv[0]->as.decimal ==
+        argv[1]->as.decimal];
+  }
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);      
+  if (2 != argc) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'=': expected exactly two arguments\n"));
   }
-  first = args->as.list->data[0];
-  second = args->as.list->data[1];
+  first = argv[0];
+  second = argv[1];
   if (first->type != second->type) {
     return f;
   } else if (is_sequential(first) && is_sequential(second)) {
@@ -3960,13 +6465,8 @@ mal_p core_eq(lvm_p this, mal_p args)
         return f;
       }
     case MAL_SYMBOL:
-      if (strcmp(first->as.symbol->data, second->as.symbol->data) == 0) {
-        return t;
-      } else {
-        return f;
-      }
     case MAL_KEYWORD:
-      if (strcmp(first->as.keyword->data, second->as.keyword->data) == 0) {
+      if (first == second) {
         return t;
       } else {
         return f;
@@ -4007,22 +6507,29 @@ mal_p core_eq(lvm_p this, mal_p args)
   return f;
 }
 
-mal_p core_lt(lvm_p this, mal_p args)
+mal_p core_lt(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_p first;
   mal_p second;
   mal_p t;
   mal_p f;
   int cmp;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if (2 > args->as.list->count || (2 < args->as.list->count &&
-      !is_nil(args->as.list->data[2]))) {
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    return this->constant.boolean[argv[0]->as.integer <
+        argv[1]->as.integer];
+  }
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return this->constant.boolean[argv[0]->as.decimal <
+        argv[1]->as.decimal];
+  }
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (2 != argc) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'<': expected exactly two arguments\n"));
   }
-  first = args->as.list->data[0];
-  second = args->as.list->data[1];
+  first = argv[0];
+  second = argv[1];
   if (!is_number(first) || !is_number(second)) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'<': expected numerical arguments\n"));
@@ -4044,22 +6551,29 @@ mal_p core_lt(lvm_p this, mal_p args)
   }
 }
 
-mal_p core_le(lvm_p this, mal_p args)
+mal_p core_le(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_p first;
   mal_p second;
   mal_p t;
   mal_p f;
   int cmp;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if (2 > args->as.list->count || (2 < args->as.list->count &&
-      !is_nil(args->as.list->data[2]))) {
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    return this->constant.boolean[argv[0]->as.integer <=
+        argv[1]->as.integer];
+  }
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return this->constant.boolean[argv[0]->as.decimal <=
+        argv[1]->as.decimal];
+  }
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (2 != argc) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'<=': expected exactly two arguments\n"));
   }
-  first = args->as.list->data[0];
-  second = args->as.list->data[1];
+  first = argv[0];
+  second = argv[1];
   if (!is_number(first) || !is_number(second)) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'<=': expected numerical arguments\n"));
@@ -4081,22 +6595,29 @@ mal_p core_le(lvm_p this, mal_p args)
   }
 }
 
-mal_p core_gt(lvm_p this, mal_p args)
+mal_p core_gt(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_p first;
   mal_p second;
   mal_p t;
   mal_p f;
   int cmp;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if (2 > args->as.list->count || (2 < args->as.list->count &&
-      !is_nil(args->as.list->data[2]))) {
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    return this->constant.boolean[argv[0]->as.integer >
+        argv[1]->as.integer];
+  }
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return this->constant.boolean[argv[0]->as.decimal >
+        argv[1]->as.decimal];
+  }
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (2 != argc) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'>': expected exactly two arguments\n"));
   }
-  first = args->as.list->data[0];
-  second = args->as.list->data[1];
+  first = argv[0];
+  second = argv[1];
   if (!is_number(first) || !is_number(second)) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'>': expected numerical arguments\n"));
@@ -4118,22 +6639,29 @@ mal_p core_gt(lvm_p this, mal_p args)
   }
 }
 
-mal_p core_ge(lvm_p this, mal_p args)
+mal_p core_ge(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_p first;
   mal_p second;
   mal_p t;
   mal_p f;
   int cmp;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if (2 > args->as.list->count || (2 < args->as.list->count &&
-      !is_nil(args->as.list->data[2]))) {
+  if (2 == argc && is_integer(argv[0]) && is_integer(argv[1])) {
+    return this->constant.boolean[argv[0]->as.integer >=
+        argv[1]->as.integer];
+  }
+  if (2 == argc && is_decimal(argv[0]) && is_decimal(argv[1])) {
+    return this->constant.boolean[argv[0]->as.decimal >=
+        argv[1]->as.decimal];
+  }
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (2 != argc) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'>=': expected exactly two arguments\n"));
   }
-  first = args->as.list->data[0];
-  second = args->as.list->data[1];
+  first = argv[0];
+  second = argv[1];
   if (!is_number(first) || !is_number(second)) {
     return mal_error(this, ERROR_RUNTIME, text_make(this,
         "'>=': expected numerical arguments\n"));
@@ -4155,317 +6683,167 @@ mal_p core_ge(lvm_p this, mal_p args)
   }
 }
 
-mal_p core_list(lvm_p this, mal_p args)
+mal_p core_list(lvm_p this, size_t argc, mal_pp argv)
 {
-  list_p list = list_make(this, args->as.list->count);
+  list_p list = list_make(this, argc);
+  list_p pairs;
   mal_p mal;
   size_t at;
   size_t in;
-  mal_p nil;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  if (0 == args->as.list->count) {
-    list_append(this, list, nil);
-    return mal_list(this, list);
-  }
-  for (at = 0; at < args->as.list->count - 1; at++) {
-    switch ((mal = args->as.list->data[at])->type) {
-    case MAL_LIST:
-      if (0 != mal->as.list->count) {
-        for (in = 0; in < mal->as.list->count - 1; in++) {
-          list_append(this, list, mal->as.list->data[in]);
-        }
-        if (!is_nil(mal->as.list->data[in])) {
-          list_append(this, list, mal->as.list->data[in]);
-        }
-      }
-      break;
-    case MAL_VECTOR:
-      if (0 != mal->as.vector->count) {
-        for (in = 0; in < mal->as.vector->count - 1; in++) {
-          list_append(this, list, mal->as.vector->data[in]);
-        }
-        if (!is_nil(mal->as.vector->data[in])) {
-          list_append(this, list, mal->as.vector->data[in]);
-        }
-      }
-      break;
-    case MAL_HASHMAP:
-      for (in = 0; in < mal->as.hashmap->count; in += 2) {
-        list_append(this, list, mal->as.hashmap->data[in]);
-      }
-      break;
-    default:
-      list_append(this, list, mal);
-    }
-  }
-  if (!is_nil(args->as.list->data[at])) {
-    switch ((mal = args->as.list->data[at])->type) {
+  for (at = 0; at < argc; at++) {
+    switch ((mal = argv[at])->type) {
     case MAL_LIST:
-      for (in = 0; in < mal->as.list->count - 1; in++) {
+      for (in = 0; in < mal->as.list->count; in++) {
         list_append(this, list, mal->as.list->data[in]);
       }
-      if (!is_nil(mal->as.list->data[in])) {
-        list_append(this, list, mal->as.list->data[in]);
+      if (mal->as.list->tail) {
+        list_append(this, list, mal->as.list->tail);
       }
       break;
     case MAL_VECTOR:
-      for (in = 0; in < mal->as.vector->count - 1; in++) {
-        list_append(this, list, mal->as.vector->data[in]);
-      }
-      if (!is_nil(mal->as.vector->data[in])) {
-        list_append(this, list, mal->as.vector->data[in]);
+      for (in = 0; in < mal->as.vector->count; in++) {
+        list_append(this, list, vector_get(this, mal->as.vector, in));
       }
       break;
     case MAL_HASHMAP:
-      for (in = 0; in < mal->as.hashmap->count; in += 2) {
-        list_append(this, list, mal->as.hashmap->data[in]);
+      pairs = hashmap_list(this, mal->as.hashmap);
+      for (in = 0; in < pairs->count; in += 2) {
+        list_append(this, list, pairs->data[in]);
       }
       break;
     default:
       list_append(this, list, mal);
     }
   }
-  list_append(this, list, nil);
   return mal_list(this, list);
 }
 
-mal_p core_vector(lvm_p this, mal_p args)
+mal_p core_vector(lvm_p this, size_t argc, mal_pp argv)
 {
-  vector_p vector = vector_make(this, args->as.list->count);
+  vector_p vector;
+  list_p pairs;
   mal_p mal;
-  size_t at;
+  size_t at = 0;
   size_t in;
-  mal_p nil;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  if (0 == args->as.list->count) {
-    vector_append(this, vector, nil);
-    return mal_vector(this, vector);
+  if (0 < argc && is_vector(argv[0])) {
+    vector = vector_copy(this, argv[0]->as.vector);
+    at = 1;
+  } else {
+    vector = vector_make(this, argc);
   }
-  for (at = 0; at < args->as.list->count - 1; at++) {
-    switch ((mal = args->as.list->data[at])->type) {
+  for (; at < argc; at++) {
+    switch ((mal = argv[at])->type) {
     case MAL_LIST:
-      for (in = 0; in < mal->as.list->count - 1; in++) {
+      for (in = 0; in < mal->as.list->count; in++) {
         vector_append(this, vector, mal->as.list->data[in]);
       }
-      if (!is_nil(mal->as.list->data[in])) {
-        vector_append(this, vector, mal->as.list->data[in]);
+      if (mal->as.list->tail) {
+        vector_append(this, vector, mal->as.list->tail);
       }
       break;
     case MAL_VECTOR:
-      for (in = 0; in < mal->as.vector->count - 1; in++) {
-        vector_append(this, vector, mal->as.vector->data[in]);
-      }
-      if (!is_nil(mal->as.vector->data[in])) {
-        vector_append(this, vector, mal->as.vector->data[in]);
+      for (in = 0; in < mal->as.vector->count; in++) {
+        vector_append(this, vector, vector_get(this, mal->as.vector, in));
       }
       break;
     case MAL_HASHMAP:
-      for (in = 0; in < mal->as.hashmap->count; in += 2) {
-        vector_append(this, vector, mal->as.hashmap->data[in]);
+      pairs = hashmap_list(this, mal->as.hashmap);
+      for (in = 0; in < pairs->count; in += 2) {
+        vector_append(this, vector, pairs->data[in]);
       }
       break;
     default:
       vector_append(this, vector, mal);
     }
   }
-  if (!is_nil(args->as.list->data[at])) {
-    switch ((mal = args->as.list->data[at])->type) {
+  return mal_vector(this, vector);
+}
+
+mal_p core_hashmap(lvm_p this, size_t argc, mal_pp argv)
+{
+  hashmap_p hashmap = hashmap_make(this, argc);
+  list_p pairs;
+  mal_p mal;
+  mal_p nil;
+  size_t at;
+  size_t in;
+  nil = mal_nil(this);
+  for (at = 0; at < argc; at++) {
+    switch ((mal = argv[at])->type) {
     case MAL_LIST:
-      for (in = 0; in < mal->as.list->count - 1; in++) {
-        vector_append(this, vector, mal->as.list->data[in]);
+      for (in = 0; in + 1 < mal->as.list->count; in += 2) {
+        hashmap_set(this, hashmap, mal->as.list->data[in],
+            mal->as.list->data[in + 1]);
       }
-      if (!is_nil(mal->as.list->data[in])) {
-        vector_append(this, vector, mal->as.list->data[in]);
+      if (in < mal->as.list->count) {
+        hashmap_set(this, hashmap, mal->as.list->data[in], nil);
       }
       break;
     case MAL_VECTOR:
-      for (in = 0; in < mal->as.vector->count - 1; in++) {
-        vector_append(this, vector, mal->as.vector->data[in]);
+      for (in = 0; in + 1 < mal->as.vector->count; in += 2) {
+        hashmap_set(this, hashmap, vector_get(this, mal->as.vector, in),
+            vector_get(this, mal->as.vector, in + 1));
       }
-      if (!is_nil(mal->as.vector->data[in])) {
-        vector_append(this, vector, mal->as.vector->data[in]);
+      if (in < mal->as.vector->count) {
+        hashmap_set(this, hashmap, vector_get(this, mal->as.vector, in), nil);
       }
       break;
     case MAL_HASHMAP:
-      for (in = 0; in < mal->as.hashmap->count; in += 2) {
-        vector_append(this, vector, mal->as.hashmap->data[in]);
+      pairs = hashmap_list(this, mal->as.hashmap);
+      for (in = 0; in < pairs->count; in += 2) {
+        hashmap_set(this, hashmap, pairs->data[in],
+            pairs->data[in + 1]);
       }
       break;
     default:
-      vector_append(this, vector, mal);
+      if (at + 1 < argc) {
+        hashmap_set(this, hashmap, argv[at],
+            argv[at + 1]);
+        at++;
+      } else {
+        hashmap_set(this, hashmap, argv[at], nil);
+      }
     }
   }
-  vector_append(this, vector, nil);
-  return mal_vector(this, vector);
+  return mal_hashmap(this, hashmap);
 }
 
-mal_p core_hashmap(lvm_p this, mal_p args)
+mal_p core_zip(lvm_p this, size_t argc, mal_pp argv)
 {
-  hashmap_p hashmap = hashmap_make(this, args->as.list->count);
-  mal_p mal;
-  mal_p nil;
   size_t at;
-  size_t in;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  if (0 == args->as.list->count) {
-    return mal_hashmap(this, hashmap);
-  }
-  for (at = 0; at < args->as.list->count - 1; at++) {
-    switch ((mal = args->as.list->data[at])->type) {
-    case MAL_LIST:
-      if (mal->as.list->count % 2 == 0) {
-        for (in = 0; in < mal->as.list->count; in += 2) {
-          hashmap_set(this, hashmap, mal->as.list->data[in],
-              mal->as.list->data[in + 1]);
-        }
-      } else {
-        for (in = 0; in < mal->as.list->count - 1; in += 2) {
-          hashmap_set(this, hashmap, mal->as.list->data[in],
-              mal->as.list->data[in + 1]);
-        }
-        hashmap_set(this, hashmap, mal->as.list->data[in], nil);
-      }
-      break;
-    case MAL_VECTOR:
-      if (mal->as.vector->count % 2 == 0) {
-        for (in = 0; in < mal->as.vector->count; in += 2) {
-          hashmap_set(this, hashmap, mal->as.vector->data[in],
-              mal->as.vector->data[in + 1]);
-        }
-      } else {
-        for (in = 0; in < mal->as.vector->count - 1; in += 2) {
-          hashmap_set(this, hashmap, mal->as.vector->data[in],
-              mal->as.vector->data[in + 1]);
-        }
-        hashmap_set(this, hashmap, mal->as.list->data[in], nil);
-      }
-      break;
-    case MAL_HASHMAP:
-      for (in = 0; in < mal->as.hashmap->count; in += 2) {
-        hashmap_set(this, hashmap, mal->as.hashmap->data[in],
-            mal->as.hashmap->data[in + 1]);
-      }
-      break;
-    default:
-      if (at + 1 != args->as.list->count - 1) {
-        hashmap_set(this, hashmap, args->as.list->data[at],
-            args->as.list->data[at + 1]);
-        at++;
-      } else {
-        hashmap_set(this, hashmap, args->as.list->data[at], nil);
-      }
-    }
-  }
-  if (!is_nil(args->as.list->data[at])) {
-    switch ((mal = args->as.list->data[at])->type) {
-    case MAL_LIST:
-      if (mal->as.list->count % 2 == 0) {
-        for (in = 0; in < mal->as.list->count; in += 2) {
-          hashmap_set(this, hashmap, mal->as.list->data[in],
-              mal->as.list->data[in + 1]);
-        }
-      } else {
-        for (in = 0; in < mal->as.list->count - 1; in += 2) {
-          hashmap_set(this, hashmap, mal->as.list->data[in],
-              mal->as.list->data[in + 1]);
-        }
-        hashmap_set(this, hashmap, mal->as.list->data[in], nil);
-      }
-      break;
-    case MAL_VECTOR:
-      if (mal->as.vector->count % 2 == 0) {
-        for (in = 0; in < mal->as.vector->count; in += 2) {
-          hashmap_set(this, hashmap, mal->as.vector->data[in],
-              mal->as.vector->data[in + 1]);
-        }
-      } else {
-        for (in = 0; in < mal->as.vector->count - 1; in += 2) {
-          hashmap_set(this, hashmap, mal->as.vector->data[in],
-              mal->as.vector->data[in + 1]);
-        }
-        hashmap_set(this, hashmap, mal->as.list->data[in], nil);
-      }
-      break;
-    case MAL_HASHMAP:
-      for (in = 0; in < mal->as.hashmap->count; in += 2) {
-        hashmap_set(this, hashmap, mal->as.hashmap->data[in],
-            mal->as.hashmap->data[in + 1]);
-      }
-      break;
-    default:
-      if (at + 1 != args->as.list->count - 1) {
-        hashmap_set(this, hashmap, args->as.list->data[at],
-            args->as.list->data[at + 1]);
-        at++;
-      } else {
-        hashmap_set(this, hashmap, args->as.list->data[at], nil);
-      }
-    }
-  }
-  return mal_hashmap(this, hashmap);
-}
-
-mal_p core_zip(lvm_p this, mal_p args)
-{
-  size_t at;
-  mal_p nil;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  if ((3 == args->as.list->count && is_nil(args->as.list->data[2])) ||
-      2 == args->as.list->count) {
-    if (is_sequential(args->as.list->data[0]) &&
-        is_sequential(args->as.list->data[1])) {
-      switch (args->as.list->data[0]->type) {
+  if (2 == argc) {
+    if (is_sequential(argv[0]) &&
+        is_sequential(argv[1])) {
+      switch (argv[0]->type) {
       case MAL_LIST:
-        switch (args->as.list->data[1]->type) {
+        switch (argv[1]->type) {
         case MAL_LIST:
-          if (args->as.list->data[0]->as.list->count >=
-              args->as.list->data[1]->as.list->count) {
-            list_p list0 = args->as.list->data[0]->as.list;
-            list_p list1 = args->as.list->data[1]->as.list;
+          if (argv[0]->as.list->count >=
+              argv[1]->as.list->count) {
+            list_p list0 = argv[0]->as.list;
+            list_p list1 = argv[1]->as.list;
             list_p result = list_make(this, list0->count << 1);
 
-            for (at = 0; at < list1->count - 1; at++) {
+            for (at = 0; at < list1->count; at++) {
               list_append(this, result, list0->data[at]);
               list_append(this, result, list1->data[at]);
             }
-            if (!is_nil(list1->data[at])) {
-              list_append(this, result, list0->data[at]);
-              list_append(this, result, list1->data[at++]);
-            }
-            for (; at < list0->count; at++) {
-              if (!is_nil(list0->data[at]) && at == list0->count - 1) {
-                list_append(this, result, list0->data[at]);
-                list_append(this, result, nil);
-              }
-            }
-            list_append(this, result, nil);
             return mal_list(this, result);
           } else {
             return mal_error(this, ERROR_RUNTIME, text_make(this, "in zip "
                 "first list has to be equal or longer then second list\n"));
           }
         case MAL_VECTOR:
-          if (args->as.list->data[0]->as.list->count >=
-              args->as.list->data[1]->as.vector->count) {
-            list_p list0 = args->as.list->data[0]->as.list;
-            vector_p vector1 = args->as.list->data[1]->as.vector;
+          if (argv[0]->as.list->count >=
+              argv[1]->as.vector->count) {
+            list_p list0 = argv[0]->as.list;
+            vector_p vector1 = argv[1]->as.vector;
             list_p result = list_make(this, list0->count << 1);
 
-            for (at = 0; at < vector1->count - 1; at++) {
-              list_append(this, result, list0->data[at]);
-              list_append(this, result, vector1->data[at]);
-            }
-            if (!is_nil(vector1->data[at])) {
+            for (at = 0; at < vector1->count; at++) {
               list_append(this, result, list0->data[at]);
-              list_append(this, result, vector1->data[at++]);
+              list_append(this, result, vector_get(this, vector1, at));
             }
-            for (; at < list0->count; at++) {
-              if (!is_nil(list0->data[at]) && at == list0->count - 1) {
-                list_append(this, result, list0->data[at]);
-                list_append(this, result, nil);
-              }
-            }
-            list_append(this, result, nil);
             return mal_list(this, result);
           } else {
             return mal_error(this, ERROR_RUNTIME,  text_make(this, "in zip "
@@ -4475,59 +6853,37 @@ mal_p core_zip(lvm_p this, mal_p args)
           return mal_error(this, ERROR_RUNTIME,
               text_concat(this, text_concat_text(this, text_make(this,
               "unsupported type of the second sequential '"), mal_print(this,
-              args->as.list->data[0], false)), "'\n"));
+              argv[0], false)), "'\n"));
         }
       case MAL_VECTOR:
-        switch (args->as.list->data[1]->type) {
+        switch (argv[1]->type) {
         case MAL_LIST:
-          if (args->as.list->data[0]->as.vector->count >=
-              args->as.list->data[1]->as.list->count) {
-            vector_p vector0 = args->as.list->data[0]->as.vector;
-            list_p list1 = args->as.list->data[1]->as.list;
+          if (argv[0]->as.vector->count >=
+              argv[1]->as.list->count) {
+            vector_p vector0 = argv[0]->as.vector;
+            list_p list1 = argv[1]->as.list;
             list_p result = list_make(this, vector0->count << 1);
 
-            for (at = 0; at < list1->count - 1; at++) {
-              list_append(this, result, vector0->data[at]);
+            for (at = 0; at < list1->count; at++) {
+              list_append(this, result, vector_get(this, vector0, at));
               list_append(this, result, list1->data[at]);
             }
-            if (!is_nil(list1->data[at])) {
-              list_append(this, result, vector0->data[at]);
-              list_append(this, result, list1->data[at++]);
-            }
-            for (; at < vector0->count; at++) {
-              if (!is_nil(vector0->data[at]) && at == vector0->count - 1) {
-                list_append(this, result, vector0->data[at]);
-                list_append(this, result, nil);
-              }
-            }
-            list_append(this, result, nil);
             return mal_list(this, result);
           } else {
             return mal_error(this, ERROR_RUNTIME, text_make(this, "in zip "
                 "first vector has to be equal or longer then second list\n"));
           }
         case MAL_VECTOR:
-          if (args->as.list->data[0]->as.vector->count >=
-              args->as.list->data[1]->as.vector->count) {
-            vector_p vector0 = args->as.list->data[0]->as.vector;
-            vector_p vector1 = args->as.list->data[1]->as.vector;
+          if (argv[0]->as.vector->count >=
+              argv[1]->as.vector->count) {
+            vector_p vector0 = argv[0]->as.vector;
+            vector_p vector1 = argv[1]->as.vector;
             list_p result = list_make(this, vector0->count << 1);
 
-            for (at = 0; at < vector1->count - 1; at++) {
-              list_append(this, result, vector0->data[at]);
-              list_append(this, result, vector1->data[at]);
-            }
-            if (!is_nil(vector1->data[at])) {
-              list_append(this, result, vector0->data[at]);
-              list_append(this, result, vector1->data[at++]);
-            }
-            for (; at < vector0->count; at++) {
-              if (!is_nil(vector0->data[at]) && at == vector0->count - 1) {
-                list_append(this, result, vector0->data[at]);
-                list_append(this, result, nil);
-              }
+            for (at = 0; at < vector1->count; at++) {
+              list_append(this, result, vector_get(this, vector0, at));
+              list_append(this, result, vector_get(this, vector1, at));
             }
-            list_append(this, result, nil);
             return mal_list(this, result);
           } else {
             return mal_error(this, ERROR_RUNTIME, text_make(this, "in zip "
@@ -4537,13 +6893,13 @@ mal_p core_zip(lvm_p this, mal_p args)
           return mal_error(this, ERROR_RUNTIME,
               text_concat(this, text_concat_text(this, text_make(this,
               "unsupported type of the second sequential '"), mal_print(this,
-              args->as.list->data[0], false)), "'\n"));
+              argv[0], false)), "'\n"));
         }
       default:
         return mal_error(this, ERROR_RUNTIME,
             text_concat(this, text_concat_text(this, text_make(this,
             "unsupported type of the first sequential '"), mal_print(this,
-            args->as.list->data[0], false)), "'\n"));
+            argv[0], false)), "'\n"));
       }
     } else {
       return mal_error(this, ERROR_RUNTIME, text_make(this,
@@ -4555,125 +6911,104 @@ mal_p core_zip(lvm_p this, mal_p args)
   }
 }
 
-mal_p core_listp(lvm_p this, mal_p args)
+mal_p core_listp(lvm_p this, size_t argc, mal_pp argv)
 {
-  mal_p nil;
   mal_p t;
   mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if ((args->as.list->count == 2 && is_nil(args->as.list->data[1])) ||
-      (args->as.list->count == 1 && !is_nil(args->as.list->data[0]))) {
-    if (is_list(args->as.list->data[0])) {
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (1 == argc) {
+    if (is_list(argv[0])) {
       return t;
     } else {
       return f;
     }
-  } else if (args->as.list->count > 1 && !is_nil(args->as.list->data[1])) {
-    size_t size = is_nil(args->as.list->data[args->as.list->count - 1]) ?
-      args->as.list->count - 1: args->as.list->count;
-    vector_p vector = vector_make(this, size);
+  } else if (argc > 1) {
+    vector_p vector = vector_make(this, argc);
     size_t at;
-    for (at = 0; at < size; at++) {
-      if (is_list(args->as.list->data[at])) {
+    for (at = 0; at < argc; at++) {
+      if (is_list(argv[at])) {
         vector_append(this, vector, t);
       } else {
         vector_append(this, vector, f);
       }
     }
-    vector_append(this, vector, nil);
     return mal_vector(this, vector);
   }
   return f;
 }
 
-mal_p core_vectorp(lvm_p this, mal_p args)
+mal_p core_vectorp(lvm_p this, size_t argc, mal_pp argv)
 {
-  mal_p nil;
   mal_p t;
   mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if ((args->as.list->count == 2 && is_nil(args->as.list->data[1])) ||
-      (args->as.list->count == 1 && !is_nil(args->as.list->data[0]))) {
-    if (is_vector(args->as.list->data[0])) {
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (1 == argc) {
+    if (is_vector(argv[0])) {
       return t;
     } else {
       return f;
     }
-  } else if (args->as.list->count > 1 && !is_nil(args->as.list->data[1])) {
-    size_t size = is_nil(args->as.list->data[args->as.list->count - 1]) ?
-      args->as.list->count - 1: args->as.list->count;
-    vector_p vector = vector_make(this, size);
+  } else if (argc > 1) {
+    vector_p vector = vector_make(this, argc);
     size_t at;
-    for (at = 0; at < size; at++) {
-      if (is_vector(args->as.list->data[at])) {
+    for (at = 0; at < argc; at++) {
+      if (is_vector(argv[at])) {
         vector_append(this, vector, t);
       } else {
         vector_append(this, vector, f);
       }
     }
-    vector_append(this, vector, nil);
     return mal_vector(this, vector);
   }
   return f;
 }
 
-mal_p core_hashmapp(lvm_p this, mal_p args)
+mal_p core_hashmapp(lvm_p this, size_t argc, mal_pp argv)
 {
-  mal_p nil;
   mal_p t;
   mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if ((args->as.list->count == 3 && is_nil(args->as.list->data[2])) ||
-      (args->as.list->count == 2 && !is_nil(args->as.list->data[1]))) {
-    if (is_hashmap(args->as.list->data[1])) {
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (1 == argc) {
+    if (is_hashmap(argv[0])) {
       return t;
     } else {
       return f;
     }
-  } else if (args->as.list->count > 2 && !is_nil(args->as.list->data[2])) {
-    size_t size = is_nil(args->as.list->data[args->as.list->count - 1]) ?
-      args->as.list->count - 1: args->as.list->count;
-    vector_p vector = vector_make(this, size);
+  } else if (argc > 1) {
+    vector_p vector = vector_make(this, argc);
     size_t at;
-    for (at = 0; at < size; at++) {
-      if (is_hashmap(args->as.list->data[at])) {
+    for (at = 0; at < argc; at++) {
+      if (is_hashmap(argv[at])) {
         vector_append(this, vector, t);
       } else {
         vector_append(this, vector, f);
       }
     }
-    vector_append(this, vector, nil);
     return mal_vector(this, vector);
   }
   return f;
 }
 
-mal_p core_envp(lvm_p this, mal_p args)
+mal_p core_envp(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_p t;
   mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if ((args->as.list->count == 3 && is_nil(args->as.list->data[2])) ||
-      (args->as.list->count == 2 && !is_nil(args->as.list->data[1]))) {
-    if (is_env(args->as.list->data[1])) {
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (1 == argc) {
+    if (is_env(argv[0])) {
       return t;
     } else {
       return f;
     }
-  } else if (args->as.list->count > 2 && !is_nil(args->as.list->data[2])) {
-    size_t size = is_nil(args->as.list->data[args->as.list->count - 1]) ?
-      args->as.list->count - 1: args->as.list->count;
-    vector_p vector = vector_make(this, size);
+  } else if (argc > 1) {
+    vector_p vector = vector_make(this, argc);
     size_t at;
-    for (at = 0; at < size; at++) {
-      if (is_env(args->as.list->data[at])) {
+    for (at = 0; at < argc; at++) {
+      if (is_env(argv[at])) {
         vector_append(this, vector, t);
       } else {
         vector_append(this, vector, f);
@@ -4684,83 +7019,80 @@ mal_p core_envp(lvm_p this, mal_p args)
   return f;
 }
 
-mal_p core_emptyp(lvm_p this, mal_p args)
+mal_p core_emptyp(lvm_p this, size_t argc, mal_pp argv)
 {
   mal_p t;
   mal_p f;
-  env_get_by_text(this, this->env, text_make(this, "boolean: true"), &t);
-  env_get_by_text(this, this->env, text_make(this, "boolean: false"), &f);
-  if ((args->as.list->count == 2 && is_nil(args->as.list->data[1])) ||
-      (args->as.list->count == 1 && !is_nil(args->as.list->data[0]))) {
-    switch (args->as.list->data[0]->type) {
+  t = mal_boolean(this, true);
+  f = mal_boolean(this, false);
+  if (1 == argc) {
+    switch (argv[0]->type) {
     case MAL_LIST:
-      if (0 == args->as.list->data[0]->as.list->count) {
+      if (0 == argv[0]->as.list->count) {
         return t;
       } else {
         return f;
       }
     case MAL_VECTOR:
-      if (0 == args->as.list->data[0]->as.vector->count) {
+      if (0 == argv[0]->as.vector->count) {
         return t;
       } else {
         return f;
       }
     case MAL_HASHMAP:
-      if (0 == args->as.list->data[0]->as.hashmap->count) {
+      if (0 == argv[0]->as.hashmap->count) {
         return t;
       } else {
         return f;
       }
     case MAL_ENV:
-      if (0 == args->as.list->data[0]->as.env->hashmap->count) {
+      if (0 == argv[0]->as.env->count) {
         return t;
       } else {
         return f;
       }
     default:
-      if (is_nil(args->as.list->data[0])) {
+      if (is_nil(argv[0])) {
         return t;
       } else {
         return f;
       }
     }
-  } else if (args->as.list->count > 1 && !is_nil(args->as.list->data[1])) {
-    size_t size = is_nil(args->as.list->data[args->as.list->count - 1]) ?
-      args->as.list->count - 1: args->as.list->count;
-    vector_p vector = vector_make(this, size);
+  } else if (argc > 1) {
+    vector_p vector = vector_make(this, argc);
     size_t at;
-    for (at = 0; at < size; at++) {
-      switch (args->as.list->data[at]->type) {
+    for (at = 0; at < argc; at++) {
+      switch (argv[at]->type) {
       case MAL_LIST:
-        if (0 == args->as.list->data[at]->as.list->count) {
+        if (0 == argv[at]->as.list->count) {
           vector_append(this, vector, t);
         } else {
           vector_append(this, vector, f);
         }
         break;
       case MAL_VECTOR:
-        if (0 == args->as.list->data[at]->as.vector->count) {
+        if (0 == argv[at]->as.vector->count) {
           vector_append(this, vector, t);
         } else {
           vector_append(this, vector, f);
         }
         break;
       case MAL_HASHMAP:
-        if (0 == args->as.list->data[at]->as.hashmap->count) {
+        if (0 == argv[at]->as.hashmap->count) {
           vector_append(this, vector, t);
         } else {
           vector_append(this, vector, f);
         }
         break;
       case MAL_ENV:
-        if (0 == args->as.list->data[at]->as.env->hashmap->count) {
+        if (0 == argv[at]->as.env->count) {
           vector_append(this, vector, t);
         } else {
           vector_append(this, vector, f);
         }
         break;
       default:
-        if (is_nil(args->as.list->data[at])) {
+        if (is_nil(argv[at])) {
           vector_append(this, vector, t);
         } else {
           vector_append(this, vector, f);
@@ -4773,45 +7105,42 @@ mal_p core_emptyp(lvm_p this, mal_p args)
   return t;
 }
 
-mal_p core_count(lvm_p this, mal_p args)
+mal_p core_count(lvm_p this, size_t argc, mal_pp argv)
 {
-  if ((args->as.list->count == 2 && is_nil(args->as.list->data[1])) ||
-      (args->as.list->count == 1 && !is_nil(args->as.list->data[0]))) {
-    switch (args->as.list->data[0]->type) {
+  if (1 == argc) {
+    switch (argv[0]->type) {
     case MAL_LIST:
-      return mal_integer(this, args->as.list->data[0]->as.list->count);
+      return mal_integer(this, argv[0]->as.list->count);
     case MAL_VECTOR:
-      return mal_integer(this, args->as.list->data[0]->as.vector->count);
+      return mal_integer(this, argv[0]->as.vector->count);
     case MAL_HASHMAP:
-      return mal_integer(this, args->as.list->data[0]->as.hashmap->count >> 1);
+      return mal_integer(this, argv[0]->as.hashmap->count);
     case MAL_ENV:
       return mal_integer(this,
-          args->as.list->data[0]->as.env->hashmap->count >> 1);
+          argv[0]->as.env->count >> 1);
     default:
       return mal_integer(this, 1);
     }
-  } else if (args->as.list->count > 1 && !is_nil(args->as.list->data[1])) {
-    size_t size = is_nil(args->as.list->data[args->as.list->count - 1]) ?
-      args->as.list->count - 1: args->as.list->count;
-    vector_p vector = vector_make(this, size);
+  } else if (argc > 1) {
+    vector_p vector = vector_make(this, argc);
     size_t at;
-    for (at = 0; at < size; at++) {
-      switch (args->as.list->data[at]->type) {
+    for (at = 0; at < argc; at++) {
+      switch (argv[at]->type) {
       case MAL_LIST:
         vector_append(this, vector, mal_integer(this,
-            args->as.list->data[at]->as.list->count));
+            argv[at]->as.list->count));
         break;
       case MAL_VECTOR:
         vector_append(this, vector, mal_integer(this,
-            args->as.list->data[at]->as.vector->count));
+            argv[at]->as.vector->count));
         break;
       case MAL_HASHMAP:
         vector_append(this, vector, mal_integer(this,
-            args->as.list->data[at]->as.hashmap->count >> 1));
+            argv[at]->as.hashmap->count));
         break;
       case MAL_ENV:
         vector_append(this, vector, mal_integer(this,
-            args->as.list->data[at]->as.env->hashmap->count >> 1));
+            argv[at]->as.env->count >> 1));
         break;
       default:
         vector_append(this, vector, mal_integer(this, 1));
@@ -4820,109 +7149,668 @@ mal_p core_count(lvm_p this, mal_p args)
     }
     return mal_vector(this, vector);
   }
-  return 0;
+  return mal_integer(this, 0);
+}
+
+/* (assoc vector index value ...) replaces the value at each index, or
+ * appends it when the index is the count; (assoc hashmap key value ...)
+ * sets each key. Both share the untouched nodes with the original */
+mal_p core_assoc(lvm_p this, size_t argc, mal_pp argv)
+{
+  vector_p vector;
+  hashmap_p hashmap;
+  size_t at;
+  if (0 == argc % 2 || (!is_vector(argv[0]) && !is_hashmap(argv[0]))) {
+    return mal_error(this, ERROR_RUNTIME, text_make(this,
+        "'assoc': expected a vector or hashmap followed by key value pairs\n"));
+  }
+  if (1 == argc) {
+    return argv[0];
+  }
+  if (is_hashmap(argv[0])) {
+    hashmap = hashmap_assoc(this, argv[0]->as.hashmap, argv[1], argv[2]);
+    if (NULL == hashmap) {
+      return mal_error(this, ERROR_RUNTIME, text_make(this,
+          "'assoc': not enough memory\n"));
+    }
+    for (at = 3; at < argc; at += 2) {
+      if (!hashmap_set(this, hashmap, argv[at], argv[at + 1])) {
+        return mal_error(this, ERROR_RUNTIME, text_make(this,
+            "'assoc': not enough memory\n"));
+      }
+    }
+    return mal_hashmap(this, hashmap);
+  }
+  vector = argv[0]->as.vector;
+  for (at = 1; at < argc; at += 2) {
+    if (!is_integer(argv[at]) || argv[at]->as.integer < 0 ||
+        (size_t)argv[at]->as.integer > vector->count) {
+      return mal_error(this, ERROR_RUNTIME, text_concat(this,
+          text_concat_text(this, text_make(this,
+          "'assoc': index out of bounds '"),
+          mal_print(this, argv[at], false)), "'\n"));
+    }
+    if ((size_t)argv[at]->as.integer == vector->count) {
+      vector = vector_copy(this, vector);
+      vector_append(this, vector, argv[at + 1]);
+    } else {
+      vector = vector_assoc(this, vector, argv[at]->as.integer,
+          argv[at + 1]);
+    }
+  }
+  return mal_vector(this, vector);
+}
+
+/* (dissoc hashmap key ...) is the hashmap without the given keys */
+mal_p core_dissoc(lvm_p this, size_t argc, mal_pp argv)
+{
+  hashmap_p hashmap;
+  size_t at;
+  if (0 == argc || !is_hashmap(argv[0])) {
+    return mal_error(this, ERROR_RUNTIME, text_make(this,
+        "'dissoc': expected a hashmap followed by keys\n"));
+  }
+  hashmap = argv[0]->as.hashmap;
+  for (at = 1; at < argc; at++) {
+    hashmap = hashmap_dissoc(this, hashmap, argv[at]);
+  }
+  return 1 == argc ? argv[0] : mal_hashmap(this, hashmap);
+}
+
+/* (pop vector) is the vector without its last value */
+mal_p core_pop(lvm_p this, size_t argc, mal_pp argv)
+{
+  vector_p vector;
+  if (1 != argc || !is_vector(argv[0]) || 0 == argv[0]->as.vector->count) {
+    return mal_error(this, ERROR_RUNTIME, text_make(this,
+        "'pop': expected a non-empty vector\n"));
+  }
+  vector = vector_copy(this, argv[0]->as.vector);
+  vector_pop(this, vector);
+  return mal_vector(this, vector);
+}
+
+mal_p core_pr_str(lvm_p this, size_t argc, mal_pp argv)
+{
+  return mal_as_str(this, argc, argv, true, " ");
+}
+
+mal_p core_str(lvm_p this, size_t argc, mal_pp argv)
+{
+  return mal_as_str(this, argc, argv, false, "");
+}
+
+mal_p core_prn(lvm_p this, size_t argc, mal_pp argv)
+{
+  mal_p nil;
+  char *str;
+  nil = mal_nil(this);
+  printf("%s\n", str = lvm_print(this, mal_as_str(this, argc, argv, true, " ")));
+  free((void *)str);
+  return nil;
+}
+
+mal_p core_println(lvm_p this, size_t argc, mal_pp argv)
+{
+  mal_p nil;
+  char *str;
+  nil = mal_nil(this);
+  printf("%s\n", str = lvm_print(this, mal_as_str(this, argc, argv, false, " ")));
+  free((void *)str);
+  return nil;
+}
+
+mal_p core_type(lvm_p this, size_t argc, mal_pp argv)
+{
+  vector_p vector;
+  size_t at;
+  if (0 == argc) {
+    return mal_symbol(this, text_make(this, "nil"));
+  }
+  if (1 == argc) {
+    return mal_type_of(this, argv[0]);
+  }
+  vector = vector_make(this, argc);
+  for (at = 0; at < argc; at++) {
+    vector_append(this, vector, mal_type_of(this, argv[at]));
+  }
+  return mal_vector(this, vector);
+}
+
+bool readers_push(lvm_p this, reader_p reader)
+{
+  readers_p stack = &this->readers;
+  if (!stack->data || stack->count >= stack->capacity) {
+    reader_pp tmp;
+    stack->capacity <<= 1;
+    tmp = (reader_pp)realloc(stack->data, stack->capacity * sizeof(reader_p));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_make(this, "not enough memory"));
+      return false;
+    }
+    stack->data = tmp;
+  }
+  stack->data[stack->count++] = reader;
+  return true;
+}
+
+bool readers_pop(lvm_p this)
+{
+  readers_p stack = &this->readers;
+  if (0 < stack->count) {
+    reader_p reader = stack->data[--stack->count];
+    free((void *)reader);
+    if (2 < stack->capacity && (stack->count << 1) < stack->capacity) {
+      reader_pp tmp;
+      stack->capacity >>= 1;
+      tmp = (reader_pp)realloc(stack->data, stack->capacity * sizeof(reader_p));
+      stack->data = tmp;
+    }
+  }
+  return false;
+}
+
+reader_p readers_get(lvm_p this)
+{
+  readers_p stack = &this->readers;
+  if (0 < stack->count) {
+    return stack->data[stack->count - 1];
+  } else {
+    return NULL;
+  }
+}
+
+mal_pp symbols_find(lvm_p this, mal_type type, text_p name, size_t hash)
+{
+  symbols_p table = &this->symbols;
+  size_t mask = table->capacity - 1;
+  size_t at = hash & mask;
+  while (table->data[at]) {
+    mal_p mal = table->data[at];
+    if (hash == mal->hash && type == mal->type &&
+        0 == text_cmp_text(this, mal->as.symbol, name)) {
+      break;
+    }
+    at = (at + 1) & mask;
+  }
+  return &table->data[at];
+}
+
+mal_p symbols_intern(lvm_p this, mal_type type, text_p name)
+{
+  size_t hash = text_hash_fnv_1a(this, name);
+  mal_pp slot;
+  mal_p mal;
+  if ((this->symbols.count + 1) << 1 > this->symbols.capacity) {
+    if (!symbols_grow(this)) {
+      return mal_error(this, ERROR_RUNTIME, text_make(this,
+          "not enough memory"));
+    }
+  }
+  slot = symbols_find(this, type, name, hash);
+  if (*slot) {
+    return *slot;
+  }
+  mal = mal_make(this, type);
+  if (MAL_SYMBOL == type) {
+    mal->as.symbol = name;
+  } else {
+    mal->as.keyword = name;
+  }
+  mal->hash = hash;
+  (*slot) = mal;
+  this->symbols.count++;
+  return mal;
+}
+
+bool symbols_grow(lvm_p this)
+{
+  symbols_p table = &this->symbols;
+  mal_pp data = table->data;
+  size_t capacity = table->capacity;
+  size_t at;
+  table->capacity = capacity ? capacity << 1 : 64;
+  table->data = (mal_pp)calloc(table->capacity, sizeof(mal_p));
+  if (NULL == table->data) {
+    table->data = data;
+    table->capacity = capacity;
+    return false;
+  }
+  for (at = 0; at < capacity; at++) {
+    if (data[at]) {
+      (*symbols_find(this, data[at]->type, data[at]->as.symbol,
+          data[at]->hash)) = data[at];
+    }
+  }
+  free((void *)data);
+  return true;
+}
+
+void symbols_free(lvm_p this)
+{
+  free((void *)this->symbols.data);
+  this->symbols.data = NULL;
+  this->symbols.count = 0;
+  this->symbols.capacity = 0;
 }
 
-mal_p core_pr_str(lvm_p this, mal_p args)
+static const size_t slab_sizes[SLAB_CLASSES] = {
+  16, 32, 48, 64, 80, 96, 128, 160, 192, 256, 288, 384, 512
+};
+
+void slab_init(lvm_p this)
 {
-  return mal_as_str(this, args, true, " ");
+  size_t at;
+  size_t size_class = 0;
+  for (at = 0; at < SLAB_CLASSES; at++) {
+    this->slab.partial[at] = NULL;
+  }
+  for (at = 0; at <= (SLAB_MAX >> 4); at++) {
+    while (slab_sizes[size_class] < (at << 4)) {
+      size_class++;
+    }
+    this->slab.lookup[at] = (unsigned char)size_class;
+  }
+  this->slab.pages = NULL;
+  this->slab.count = 0;
+  this->slab.capacity = 0;
+}
+
+void *slab_alloc(lvm_p this, size_t size)
+{
+  slab_page_p page;
+  size_t size_class;
+  void *ptr;
+  if (0 == size || SLAB_MAX < size) {
+    return calloc(1, size);
+  }
+  size_class = this->slab.lookup[(size + 15) >> 4];
+  page = this->slab.partial[size_class];
+  if (NULL == page) {
+    page = slab_page_make(this, size_class);
+    if (NULL == page) {
+      return NULL;
+    }
+  }
+  if (page->free) {
+    ptr = page->free;
+    page->free = *(void **)ptr;
+  } else {
+    ptr = page->bump;
+    page->bump += page->size;
+  }
+  page->used++;
+  if (NULL == page->free && page->bump + page->size > page->end) {
+    this->slab.partial[size_class] = page->next;
+    if (page->next) {
+      page->next->prev = NULL;
+    }
+    page->next = NULL;
+    page->listed = false;
+  }
+  memset(ptr, 0, size);
+  return ptr;
+}
+
+void *slab_realloc(lvm_p this, void *ptr, size_t old, size_t size)
+{
+  void *tmp;
+  if (NULL == ptr) {
+    return slab_alloc(this, size);
+  }
+  if (SLAB_MAX < old && SLAB_MAX < size) {
+    return realloc(ptr, size);
+  }
+  if (0 < old && old <= SLAB_MAX && 0 < size && size <= SLAB_MAX &&
+      this->slab.lookup[(old + 15) >> 4] ==
+      this->slab.lookup[(size + 15) >> 4]) {
+    return ptr;
+  }
+  tmp = slab_alloc(this, size);
+  if (NULL == tmp) {
+    return NULL;
+  }
+  memcpy(tmp, ptr, old < size ? old : size);
+  slab_free(this, ptr, old);
+  return tmp;
+}
+
+void slab_free(lvm_p this, void *ptr, size_t size)
+{
+  slab_page_p page;
+  if (NULL == ptr) {
+    return;
+  }
+  if (0 == size || SLAB_MAX < size) {
+    free(ptr);
+    return;
+  }
+  page = slab_page_find(this, ptr);
+  *(void **)ptr = page->free;
+  page->free = ptr;
+  page->used--;
+  if (0 == page->used &&
+      (this->slab.partial[page->size_class] != page || page->next)) {
+    slab_page_free(this, page);
+    return;
+  }
+  if (!page->listed) {
+    page->prev = NULL;
+    page->next = this->slab.partial[page->size_class];
+    if (page->next) {
+      page->next->prev = page;
+    }
+    this->slab.partial[page->size_class] = page;
+    page->listed = true;
+  }
+}
+
+slab_page_p slab_page_make(lvm_p this, size_t size_class)
+{
+  slab_p slab = &this->slab;
+  slab_page_p page;
+  size_t low = 0;
+  size_t high = slab->count;
+  if (slab->count >= slab->capacity) {
+    slab_page_pp tmp;
+    size_t capacity = slab->capacity ? slab->capacity << 1 : 64;
+    tmp = (slab_page_pp)realloc(slab->pages, capacity * sizeof(slab_page_p));
+    if (NULL == tmp) {
+      return NULL;
+    }
+    slab->pages = tmp;
+    slab->capacity = capacity;
+  }
+  page = (slab_page_p)malloc(sizeof(slab_page_t) + SLAB_PAGE);
+  if (NULL == page) {
+    return NULL;
+  }
+  page->base = (char *)(page + 1);
+  page->bump = page->base;
+  page->end = page->base + SLAB_PAGE;
+  page->free = NULL;
+  page->used = 0;
+  page->size = slab_sizes[size_class];
+  page->size_class = size_class;
+  page->prev = NULL;
+  page->next = slab->partial[size_class];
+  if (page->next) {
+    page->next->prev = page;
+  }
+  slab->partial[size_class] = page;
+  page->listed = true;
+  while (low < high) {
+    size_t middle = (low + high) >> 1;
+    if ((size_t)slab->pages[middle]->base < (size_t)page->base) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  memmove(&slab->pages[low + 1], &slab->pages[low],
+      (slab->count - low) * sizeof(slab_page_p));
+  slab->pages[low] = page;
+  slab->count++;
+  return page;
+}
+
+slab_page_p slab_page_find(lvm_p this, void *ptr)
+{
+  slab_p slab = &this->slab;
+  size_t low = 0;
+  size_t high = slab->count;
+  while (high - low > 1) {
+    size_t middle = (low + high) >> 1;
+    if ((size_t)slab->pages[middle]->base <= (size_t)ptr) {
+      low = middle;
+    } else {
+      high = middle;
+    }
+  }
+  return slab->pages[low];
+}
+
+void slab_page_free(lvm_p this, slab_page_p page)
+{
+  slab_p slab = &this->slab;
+  size_t at;
+  size_t size_class = page->size_class;
+  if (page->listed) {
+    if (page->prev) {
+      page->prev->next = page->next;
+    } else {
+      slab->partial[size_class] = page->next;
+    }
+    if (page->next) {
+      page->next->prev = page->prev;
+    }
+  }
+  for (at = 0; page != slab->pages[at]; at++) {
+  }
+  memmove(&slab->pages[at], &slab->pages[at + 1],
+      (slab->count - at - 1) * sizeof(slab_page_p));
+  slab->count--;
+  free((void *)page);
+}
+
+void slab_destroy(lvm_p this)
+{
+  size_t at;
+  for (at = 0; at < this->slab.count; at++) {
+    free((void *)this->slab.pages[at]);
+  }
+  free((void *)this->slab.pages);
+  slab_init(this);
+}
+
+size_t roots_push(lvm_p this, gc_p gc)
+{
+  roots_p stack = &this->roots;
+  if (stack->count >= stack->capacity) {
+    gc_pp tmp;
+    size_t capacity = stack->capacity ? stack->capacity << 1 : 64;
+    tmp = (gc_pp)realloc(stack->data, capacity * sizeof(gc_p));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_make(this,
+          "not enough memory"));
+      return stack->count;
+    }
+    stack->data = tmp;
+    stack->capacity = capacity;
+  }
+  stack->data[stack->count] = gc;
+  return stack->count++;
+}
+
+void roots_set(lvm_p this, size_t slot, gc_p gc)
+{
+  if (slot < this->roots.count) {
+    this->roots.data[slot] = gc;
+  }
+}
+
+void roots_pop(lvm_p this, size_t base)
+{
+  if (base < this->roots.count) {
+    this->roots.count = base;
+  }
+}
+
+void roots_free(lvm_p this)
+{
+  free((void *)this->roots.data);
+  this->roots.data = NULL;
+  this->roots.count = 0;
+  this->roots.capacity = 0;
+}
+
+bool values_push(lvm_p this, mal_p mal)
+{
+  values_p stack = &this->values;
+  if (stack->count >= stack->capacity) {
+    mal_pp tmp;
+    size_t capacity = stack->capacity ? stack->capacity << 1 : 256;
+    tmp = (mal_pp)realloc(stack->data, capacity * sizeof(mal_p));
+    if (NULL == tmp) {
+      error_append(this, ERROR_RUNTIME, text_make(this,
+          "not enough memory"));
+      return false;
+    }
+    stack->data = tmp;
+    stack->capacity = capacity;
+  }
+  stack->data[stack->count++] = mal;
+  return true;
+}
+
+void values_pop(lvm_p this, size_t base)
+{
+  if (base < this->values.count) {
+    this->values.count = base;
+  }
+}
+
+void values_free(lvm_p this)
+{
+  free((void *)this->values.data);
+  this->values.data = NULL;
+  this->values.count = 0;
+  this->values.capacity = 0;
+}
+
+bool frames_push(lvm_p this, frame_p frame)
+{
+  frames_p stack = &this->frames;
+  if (stack->count >= stack->max) {
+    return false;
+  }
+  if (stack->count >= stack->capacity) {
+    frame_p tmp;
+    size_t capacity = stack->capacity ? stack->capacity << 1 : 64;
+    tmp = (frame_p)realloc(stack->data, capacity * sizeof(frame_t));
+    if (NULL == tmp) {
+      return false;
+    }
+    stack->data = tmp;
+    stack->capacity = capacity;
+  }
+  stack->data[stack->count++] = *frame;
+  return true;
+}
+
+void frames_free(lvm_p this)
+{
+  free((void *)this->frames.data);
+  this->frames.data = NULL;
+  this->frames.count = 0;
+  this->frames.capacity = 0;
+}
+
+bool catches_push(lvm_p this, catch_p record)
+{
+  catches_p stack = &this->catches;
+  if (stack->count >= stack->capacity) {
+    catch_p tmp;
+    size_t capacity = stack->capacity ? stack->capacity << 1 : 16;
+    tmp = (catch_p)realloc(stack->data, capacity * sizeof(catch_t));
+    if (NULL == tmp) {
+      return false;
+    }
+    stack->data = tmp;
+    stack->capacity = capacity;
+  }
+  stack->data[stack->count++] = *record;
+  return true;
 }
 
-mal_p core_str(lvm_p this, mal_p args)
+void catches_free(lvm_p this)
 {
-  return mal_as_str(this, args, false, "");
+  free((void *)this->catches.data);
+  this->catches.data = NULL;
+  this->catches.count = 0;
+  this->catches.capacity = 0;
 }
 
-mal_p core_prn(lvm_p this, mal_p args)
+void envs_free(lvm_p this)
 {
-  mal_p nil;
-  char *str;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  printf("%s\n", str = lvm_print(this, mal_as_str(this, args, true, " ")));
-  free((void *)str);
-  return nil;
+  env_pop(this, 0);
+  free((void *)this->envs.data);
+  this->envs.data = NULL;
+  this->envs.count = 0;
+  this->envs.capacity = 0;
 }
 
-mal_p core_println(lvm_p this, mal_p args)
+position_p positions_find(lvm_p this, mal_p mal)
 {
-  mal_p nil;
-  char *str;
-  env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-  printf("%s\n", str = lvm_print(this, mal_as_str(this, args, false, " ")));
-  free((void *)str);
-  return nil;
+  positions_p table = &this->positions;
+  size_t mask = table->capacity - 1;
+  size_t at = ((size_t)mal >> 4) & mask;
+  while (table->data[at].mal && mal != table->data[at].mal) {
+    at = (at + 1) & mask;
+  }
+  return &table->data[at];
 }
 
-mal_p core_type(lvm_p this, mal_p args)
+mal_p positions_set(lvm_p this, mal_p mal, token_p token)
 {
-  vector_p vector = vector_make(this, 0);
-  mal_p nil;
-  size_t at = 0;
-  if ((1 == args->as.list->count && is_nil(args->as.list->data[0])) ||
-      0 == args->as.list->count) {
-    return mal_symbol(this, text_make(this, "nil"));
-  }
-  if (2 == args->as.list->count) {
-    return mal_type_of(this, args->as.list->data[0]);
-  } else {
-    if (1 <= args->as.list->count && !is_nil(args->as.list->data[at++])) {
-      vector_append(this, vector, mal_type_of(this, args->as.list->data[0]));
-    }
-    for (; at < args->as.list->count - 1; at++) {
-      vector_append(this, vector, mal_type_of(this, args->as.list->data[at]));
-    }
-    if (!is_nil(args->as.list->data[at])) {
-      vector_append(this, vector, mal_type_of(this, args->as.list->data[at]));
+  positions_p table = &this->positions;
+  position_p position;
+  if ((table->count + 1) << 1 > table->capacity) {
+    if (!positions_rebuild(this, table->capacity ? table->capacity << 1 : 64,
+        false)) {
+      return mal;
     }
-    env_get_by_text(this, this->env, text_make(this, "nil: nil"), &nil);
-    vector_append(this, vector, nil);
-    return mal_vector(this, vector);
   }
+  position = positions_find(this, mal);
+  if (NULL == position->mal) {
+    position->mal = mal;
+    table->count++;
+  }
+  position->line = token->line;
+  position->column = token->column;
+  return mal;
 }
 
-bool readers_push(lvm_p this, reader_p reader)
+position_p positions_get(lvm_p this, mal_p mal)
 {
-  readers_p stack = &this->readers;
-  if (!stack->data || stack->count >= stack->capacity) {
-    reader_pp tmp;
-    stack->capacity <<= 1;
-    tmp = (reader_pp)realloc(stack->data, stack->capacity * sizeof(reader_p));
-    if (NULL == tmp) {
-      error_append(this, ERROR_RUNTIME, text_make(this, "not enough memory"));
-      return false;
-    }
-    stack->data = tmp;
+  position_p position;
+  if (0 == this->positions.count) {
+    return NULL;
   }
-  printf("nOK:%p\n", (void *)stack->data);
-  stack->data[stack->count++] = reader;
-  return true;
+  position = positions_find(this, mal);
+  return position->mal ? position : NULL;
 }
 
-bool readers_pop(lvm_p this)
+bool positions_rebuild(lvm_p this, size_t capacity, bool purge)
 {
-  readers_p stack = &this->readers;
-  if (0 < stack->count) {
-    reader_p reader = stack->data[--stack->count];
-    free((void *)reader);
-    if ((stack->count << 1) < stack->capacity) {
-      reader_pp tmp;
-      stack->capacity >>= 1;
-      tmp = (reader_pp)realloc(stack->data, stack->capacity * sizeof(reader_p));
-      stack->data = tmp;
+  positions_p table = &this->positions;
+  position_p data = table->data;
+  size_t old = table->capacity;
+  size_t at;
+  table->data = (position_p)calloc(capacity, sizeof(position_t));
+  if (NULL == table->data) {
+    table->data = data;
+    return false;
+  }
+  table->capacity = capacity;
+  table->count = 0;
+  for (at = 0; at < old; at++) {
+    mal_p mal = data[at].mal;
+    if (mal && (!purge || !lvm_gc_unmarked(this, (gc_p)mal))) {
+      (*positions_find(this, mal)) = data[at];
+      table->count++;
     }
   }
-  return false;
+  free((void *)data);
+  return true;
 }
 
-reader_p readers_get(lvm_p this)
+void positions_free(lvm_p this)
 {
-  readers_p stack = &this->readers;
-  if (0 < stack->count) {
-    return stack->data[stack->count];
-  } else {
-    printf("nOK\n");
-    return NULL;
-  }
+  free((void *)this->positions.data);
+  this->positions.data = NULL;
+  this->positions.count = 0;
+  this->positions.capacity = 0;
 }
 
 
@@ -4934,10 +7822,34 @@ mal_p lvm_read(lvm_p this, char *str)
 }
 
 mal_p lvm_eval(lvm_p this, mal_p ast, env_p env)
+{
+  return lvm_run(this, compile(this, ast), env);
+}
+
+mal_p eval_form(lvm_p this, mal_p ast, env_p env)
+{
+  size_t base;
+  mal_p result;
+  /* the tree walker recurses on the C stack, unlike the compiled code */
+  if (this->frames.depth >= this->frames.depth_max) {
+    return mal_error(this, ERROR_RUNTIME, text_concat(this,
+        text_concat_text(this, text_make(this,
+        "'eval': nesting depth limit reached '"),
+        text_make_integer(this, this->frames.depth_max)), "'\n"));
+  }
+  this->frames.depth++;
+  base = roots_push(this, (gc_p)ast);
+  roots_push(this, (gc_p)env);
+  result = eval_loop(this, ast, env, base);
+  roots_pop(this, base);
+  this->frames.depth--;
+  return result;
+}
+
+mal_p eval_loop(lvm_p this, mal_p ast, env_p env, size_t root)
 {
   while (true) {
     mal_p evaluated;
-    list_p params;
     mal_p callable;
     closure_p closure;
     list_p parameters;
@@ -4946,6 +7858,14 @@ mal_p lvm_eval(lvm_p this, mal_p ast, env_p env)
     list_p list;
     size_t at;
     size_t in;
+    size_t base;
+    size_t argc;
+    mal_pp argv;
+    roots_set(this, root, (gc_p)ast);
+    roots_set(this, root + 1, (gc_p)env);
+    if (this->gc.count >= this->gc.total) {
+      lvm_gc(this);
+    }
     if (is_eoi(ast) || is_nil(ast)) {
       return ast;
     }
@@ -4955,96 +7875,111 @@ mal_p lvm_eval(lvm_p this, mal_p ast, env_p env)
     if (0 == ast->as.list->count) {
       return ast;
     }
-    if (MAL_SYMBOL == ast->as.list->data[0]->type) {
-      if (0 == text_cmp(this, ast->as.list->data[0]->as.symbol, "def!")) {
-        return eval_def_bang(this, ast, env);
-      }
-      if (0 == text_cmp(this, ast->as.list->data[0]->as.symbol, "let*")) {
-        ast = eval_let_star(this, ast, &env);
-        if (is_error(ast)) {
-          return ast;
-        }
-        continue;
+    switch (ast->as.list->data[0]->special) {
+    case SPECIAL_DEF_BANG:
+      return eval_def_bang(this, ast, env);
+    case SPECIAL_LET_STAR:
+      ast = eval_let_star(this, ast, &env);
+      if (is_error(ast)) {
+        return ast;
       }
-      if (0 == text_cmp(this, ast->as.list->data[0]->as.symbol, "if")) {
-        ast = eval_if(this, ast, &env);
-        if (is_error(ast)) {
-          return ast;
-        }
-        continue;
+      continue;
+    case SPECIAL_IF:
+      ast = eval_if(this, ast, &env);
+      if (is_error(ast)) {
+        return ast;
       }
-      if (0 == text_cmp(this, ast->as.list->data[0]->as.symbol, "fn*")) {
-        return eval_fn_star(this, ast, env);
+      continue;
+    case SPECIAL_FN_STAR:
+      return eval_fn_star(this, ast, env);
+    case SPECIAL_DO:
+      ast = eval_do(this, ast, env);
+      if (is_error(ast)) {
+        return ast;
       }
-      if (0 == text_cmp(this, ast->as.list->data[0]->as.symbol, "do")) {
-        ast = eval_do(this, ast, env);
-        if (is_error(ast)) {
-          return ast;
-        }
-        continue;
+      continue;
+    case SPECIAL_ENV:
+      return mal_env(this, env);
+    case SPECIAL_TRY_STAR:
+      return eval_try_star(this, ast, env);
+    case SPECIAL_LOOP:
+      return eval_loop_form(this, ast, env);
+    case SPECIAL_RECUR:
+      return eval_recur_form(this, ast, env);
+    case SPECIAL_NONE:
+    default:
+      break;
+    }
+    base = this->values.count;
+    for (at = 0; at <= ast->as.list->count; at++) {
+      if (at == ast->as.list->count && !ast->as.list->tail) {
+        break;
       }
-      if (0 == text_cmp(this, ast->as.list->data[0]->as.symbol, "..")) {
-        return mal_env(this, env);
+      evaluated = eval_form(this, at < ast->as.list->count ?
+          ast->as.list->data[at] : ast->as.list->tail, env);
+      if (MAL_ERROR == evaluated->type || !values_push(this, evaluated)) {
+        values_pop(this, base);
+        return evaluated;
       }
     }
-    evaluated = eval_ast(this, ast, env);
-    if (MAL_ERROR == evaluated->type) {
-      return evaluated;
-    }
-    callable = evaluated->as.list->data[0];
-    params = list_params(this, evaluated->as.list);
+    callable = this->values.data[base];
+    argc = this->values.count - base - 1;
+    argv = this->values.data + base + 1;
     switch (callable->type) {
     case MAL_SYMBOL:
+      values_pop(this, base);
       break;
     case MAL_FUNCTION:
-      return (callable->as.function->definition)(this, mal_list(this, params));
+      evaluated = (callable->as.function->definition)(this, argc, argv);
+      values_pop(this, base);
+      return evaluated;
     case MAL_CLOSURE:
       closure = callable->as.closure;
-      parameters = closure->parameters->as.list;
-      arity = parameters->count - 1;
-      arguments = params->count - 1;
+      parameters = closure->lambda->parameters->as.list;
+      arity = parameters->count;
+      arguments = argc;
       if (arity > arguments) {
+        values_pop(this, base);
         return mal_error(this, ERROR_RUNTIME,
             text_concat(this, text_concat_text(this, text_make(this,
             "'fn*': too few arguments supplied to the function '"),
             text_make_integer(this, arguments)), "'\n"));
-      } else if ((arity < arguments) && !closure->more) {
+      } else if ((arity < arguments) && is_nil(closure->lambda->more)) {
+        values_pop(this, base);
         return mal_error(this, ERROR_RUNTIME,
             text_concat(this, text_concat_text(this, text_make(this,
             "'fn*': too many arguments supplied to the function '"),
             text_make_integer(this, arguments)), "'\n"));
       } else {
-        env = env_make(this, closure->env, parameters, params,
-            closure->more, 0);
-        ast = callable->as.closure->definition;
+        env = env_make(this, closure->env, parameters, argc, argv,
+            closure->lambda->more, (parameters->count + 1) << 1);
+        values_pop(this, base);
+        ast = callable->as.closure->lambda->definition;
         if (is_error(ast)) {
           return ast;
         }
         continue;
       }
     case MAL_HASHMAP:
-      for (at = 0; at < params->count; at++) {
-        if (is_nil(params->data[at]) && at == params->count - 1) {
-          return callable;
-        }
-        if (is_keyword(params->data[at])) {
-          hashmap_get(this, callable->as.hashmap, params->data[at], &evaluated);
-          list = list_make(this, params->count);
-          params = list_offset(this, params, 1);
-          list_append(this, list, evaluated);
-          for (in = 0; in < params->count; in++) {
-            list_append(this, list, params->data[in]);
-          }
-          if (list->count > 2) {
-            ast = mal_list(this, list);
-          } else {
-            ast = evaluated;
-          }
-        }
-        break;
+      if (0 == argc || !is_keyword(argv[0])) {
+        values_pop(this, base);
+        return 0 == argc ? callable : mal_nil(this);
+      }
+      hashmap_get(this, callable->as.hashmap, argv[0], &evaluated);
+      list = list_make(this, argc);
+      list_append(this, list, evaluated);
+      for (in = 1; in < argc; in++) {
+        list_append(this, list, argv[in]);
+      }
+      if (list->count > 1) {
+        ast = mal_list(this, list);
+      } else {
+        ast = evaluated;
       }
+      values_pop(this, base);
       continue;
     default:
+      values_pop(this, base);
       return mal_error(this, ERROR_RUNTIME,
           text_concat(this, text_concat_text(this, text_make(this,
           "first list item not callable '"), mal_print(this, callable, false)),
@@ -5054,6 +7989,491 @@ mal_p lvm_eval(lvm_p this, mal_p ast, env_p env)
   }
 }
 
+mal_p eval_apply(lvm_p this, mal_p callable, size_t argc, mal_pp argv,
+    env_p env)
+{
+  mal_p value;
+  list_p list;
+  size_t at;
+  switch (callable->type) {
+  case MAL_FUNCTION:
+    return (callable->as.function->definition)(this, argc, argv);
+  case MAL_HASHMAP:
+    if (0 == argc || !is_keyword(argv[0])) {
+      return 0 == argc ? callable : mal_nil(this);
+    }
+    hashmap_get(this, callable->as.hashmap, argv[0], &value);
+    if (1 == argc) {
+      return eval_form(this, value, env);
+    }
+    list = list_make(this, argc);
+    list_append(this, list, value);
+    for (at = 1; at < argc; at++) {
+      list_append(this, list, argv[at]);
+    }
+    return eval_form(this, mal_list(this, list), env);
+  default:
+    return mal_error(this, ERROR_RUNTIME,
+        text_concat(this, text_concat_text(this, text_make(this,
+        "first list item not callable '"), mal_print(this, callable, false)),
+        "'\n"));
+  }
+}
+
+mal_p lvm_run(lvm_p this, code_p code, env_p env)
+{
+  frame_t frame;
+  instr_p instr;
+  handler_t handler;
+  size_t base = this->values.count;
+  size_t envs = this->envs.count;
+  size_t bottom = this->frames.count;
+  size_t depth = this->frames.depth;
+  size_t catches = this->catches.count;
+  size_t root = roots_push(this, (gc_p)code);
+  roots_push(this, (gc_p)env);
+  frame.code = code;
+  frame.env = env;
+  frame.ip = 0;
+  frame.base = base;
+  frame.bottom = bottom;
+  frame.envs = envs;
+  frame.version = 0;
+  frame.result = NULL;
+  frame.root = root;
+  /* errors raised under this run land here, and resume at the innermost
+   * try* it entered or leave it as its result */
+  handler.outer = this->handler;
+  this->handler = &handler;
+  if (0 != setjmp(handler.jump)) {
+    op_catch(this, &frame, handler.error, catches);
+  }
+  while (NULL == frame.result) {
+    instr = frame.code->data + frame.ip++;
+    (instr->op)(this, &frame, instr);
+  }
+  this->handler = handler.outer;
+  this->catches.count = catches;
+  this->frames.count = bottom;
+  this->frames.depth = depth;
+  env_pop(this, envs);
+  values_pop(this, base);
+  roots_pop(this, root);
+  return frame.result;
+}
+
+mal_p lvm_try(lvm_p this, handler_p handler, mal_p ast, env_p env)
+{
+  mal_p value;
+  handler->roots = this->roots.count;
+  handler->values = this->values.count;
+  handler->frames = this->frames.count;
+  handler->depth = this->frames.depth;
+  handler->envs = this->envs.count;
+  handler->errors = this->error ? this->error->count : 0;
+  handler->error = NULL;
+  handler->outer = this->handler;
+  this->handler = handler;
+  if (0 == setjmp(handler->jump)) {
+    value = lvm_eval(this, ast, env);
+  } else {
+    roots_pop(this, handler->roots);
+    values_pop(this, handler->values);
+    this->frames.count = handler->frames;
+    this->frames.depth = handler->depth;
+    env_pop(this, handler->envs);
+    value = handler->error;
+  }
+  this->handler = handler->outer;
+  return value;
+}
+
+void lvm_raise(lvm_p this, mal_p error)
+{
+  if (this->handler) {
+    this->handler->error = error;
+    longjmp(this->handler->jump, 1);
+  }
+}
+
+void op_push(lvm_p this, frame_p frame, mal_p value)
+{
+  if (is_error(value)) {
+    lvm_raise(this, value);
+    frame->result = value;
+  } else if (!values_push(this, value)) {
+    frame->result = value;
+  }
+}
+
+void op_constant(lvm_p this, frame_p frame, instr_p instr)
+{
+  op_push(this, frame, instr->constant);
+}
+
+void op_symbol(lvm_p this, frame_p frame, instr_p instr)
+{
+  env_p env;
+  size_t pair;
+  if (instr->version == this->version) {
+    /* the frames under the lookup are checked once per version, any
+     * binding that could hide a cached global bumps it */
+    if (frame->version != this->version) {
+      for (env = frame->env; env && env != this->env && !env->shadow;
+          env = env->outer) {
+      }
+      frame->shadow = env != this->env;
+      frame->version = this->version;
+    }
+    if (!frame->shadow) {
+      op_push(this, frame, this->env->data[instr->operand + 1]);
+      return;
+    }
+  }
+  for (env = frame->env; env; env = env->outer) {
+    pair = env_find(this, env, instr->constant);
+    if (pair < env->count) {
+      if (env == this->env) {
+        instr->operand = pair;
+        instr->version = this->version;
+      }
+      op_push(this, frame, env->data[pair + 1]);
+      return;
+    }
+  }
+  op_push(this, frame, eval_ast(this, instr->constant, frame->env));
+}
+
+void op_local(lvm_p this, frame_p frame, instr_p instr)
+{
+  op_push(this, frame, env_local(this, frame->env, instr->constant));
+}
+
+void op_eval(lvm_p this, frame_p frame, instr_p instr)
+{
+  op_push(this, frame, eval_form(this, instr->constant, frame->env));
+}
+
+void op_closure(lvm_p this, frame_p frame, instr_p instr)
+{
+  op_push(this, frame, eval_fn_star(this, instr->constant, frame->env));
+}
+
+void op_env(lvm_p this, frame_p frame, instr_p instr)
+{
+  (void)instr;
+  op_push(this, frame, mal_env(this, frame->env));
+}
+
+void op_vector(lvm_p this, frame_p frame, instr_p instr)
+{
+  size_t base = this->values.count - instr->operand;
+  vector_p vector = vector_make(this, instr->operand);
+  size_t at;
+  for (at = base; at < this->values.count; at++) {
+    vector_append(this, vector, this->values.data[at]);
+  }
+  values_pop(this, base);
+  op_push(this, frame, mal_vector(this, vector));
+}
+
+void op_hashmap(lvm_p this, frame_p frame, instr_p instr)
+{
+  size_t base = this->values.count - (instr->operand << 1);
+  hashmap_p hashmap = hashmap_make(this, instr->operand);
+  size_t at;
+  for (at = base; at < this->values.count; at += 2) {
+    hashmap_set(this, hashmap, this->values.data[at],
+        this->values.data[at + 1]);
+  }
+  values_pop(this, base);
+  op_push(this, frame, mal_hashmap(this, hashmap));
+}
+
+void op_try(lvm_p this, frame_p frame, instr_p instr)
+{
+  catch_t record;
+  record.frame = *frame;
+  record.frame.ip = instr->operand;
+  record.roots = this->roots.count;
+  record.values = this->values.count;
+  record.frames = this->frames.count;
+  record.depth = this->frames.depth;
+  record.envs = this->envs.count;
+  record.errors = this->error ? this->error->count : 0;
+  if (!catches_push(this, &record)) {
+    op_push(this, frame, mal_error(this, ERROR_RUNTIME,
+        text_make(this, "'try*': not enough memory\n")));
+  }
+}
+
+void op_untry(lvm_p this, frame_p frame, instr_p instr)
+{
+  (void)frame;
+  (void)instr;
+  this->catches.count--;
+}
+
+void op_catch(lvm_p this, frame_p frame, mal_p error, size_t catches)
+{
+  catch_p record;
+  text_p message;
+  if (this->catches.count == catches) {
+    frame->result = error;
+    return;
+  }
+  record = this->catches.data + --this->catches.count;
+  roots_pop(this, record->roots);
+  values_pop(this, record->values);
+  this->frames.count = record->frames;
+  this->frames.depth = record->depth;
+  env_pop(this, record->envs);
+  if (this->error) {
+    this->error->count = record->errors;
+  }
+  *frame = record->frame;
+  roots_set(this, frame->root, (gc_p)frame->code);
+  roots_set(this, frame->root + 1, (gc_p)frame->env);
+  /* bind the message, an error value would be raised again when loaded */
+  message = text_make(this, error->as.error->data);
+  if (message->count && '\n' == message->data[message->count - 1]) {
+    message->data[--message->count] = 0x00;
+  }
+  op_push(this, frame, mal_string(this, message));
+}
+
+void op_def(lvm_p this, frame_p frame, instr_p instr)
+{
+  env_shadow(this, frame->env, instr->constant);
+  /* the name may turn global later, after the caches are filled */
+  if (frame->env != this->env && !frame->env->shadow) {
+    frame->env->shadow = true;
+    this->version++;
+  }
+  env_set(this, frame->env, instr->constant,
+      this->values.data[this->values.count - 1]);
+}
+
+void op_let(lvm_p this, frame_p frame, instr_p instr)
+{
+  frame->env = env_make(this, frame->env, NULL, 0, NULL, NULL,
+      instr->operand);
+  roots_set(this, frame->root + 1, (gc_p)frame->env);
+}
+
+/* no closure or env made inside the form can outlive its frame, even
+ * when the code around it makes some, so the frame can be popped */
+void op_let_stack(lvm_p this, frame_p frame, instr_p instr)
+{
+  frame->env = env_push(this, frame->env, NULL, 0, NULL, NULL,
+      instr->operand);
+  roots_set(this, frame->root + 1, (gc_p)frame->env);
+}
+
+void op_bind(lvm_p this, frame_p frame, instr_p instr)
+{
+  env_shadow(this, frame->env, instr->constant);
+  env_set(this, frame->env, instr->constant,
+      this->values.data[this->values.count - 1]);
+  values_pop(this, this->values.count - 1);
+}
+
+void op_unlet(lvm_p this, frame_p frame, instr_p instr)
+{
+  bool stack = GC_STACK == frame->env->gc.mark;
+  (void)instr;
+  frame->env = frame->env->outer;
+  if (stack) {
+    env_pop(this, this->envs.count - 1);
+  }
+  frame->version = 0;
+  roots_set(this, frame->root + 1, (gc_p)frame->env);
+}
+
+void op_pop(lvm_p this, frame_p frame, instr_p instr)
+{
+  (void)frame;
+  (void)instr;
+  values_pop(this, this->values.count - 1);
+}
+
+void op_jump(lvm_p this, frame_p frame, instr_p instr)
+{
+  (void)this;
+  frame->ip = instr->operand;
+}
+
+void op_jump_false(lvm_p this, frame_p frame, instr_p instr)
+{
+  mal_p value = this->values.data[this->values.count - 1];
+  values_pop(this, this->values.count - 1);
+  if (is_false(value) || is_nil(value)) {
+    frame->ip = instr->operand;
+  }
+}
+
+void op_return(lvm_p this, frame_p frame, instr_p instr)
+{
+  mal_p value = this->values.data[this->values.count - 1];
+  (void)instr;
+  if (this->frames.count == frame->bottom) {
+    frame->result = value;
+    return;
+  }
+  values_pop(this, frame->base);
+  env_pop(this, frame->envs);
+  *frame = this->frames.data[--this->frames.count];
+  roots_set(this, frame->root, (gc_p)frame->code);
+  roots_set(this, frame->root + 1, (gc_p)frame->env);
+  op_push(this, frame, value);
+}
+
+void op_recur(lvm_p this, frame_p frame, instr_p instr)
+{
+  size_t depth = instr->operand >> LOCAL_BITS;
+  size_t count = instr->operand & LOCAL_MASK;
+  size_t base = this->values.count - count;
+  size_t at;
+  bool stack;
+  for (; depth; depth--) {
+    stack = GC_STACK == frame->env->gc.mark;
+    frame->env = frame->env->outer;
+    if (stack) {
+      env_pop(this, this->envs.count - 1);
+    }
+    frame->version = 0;
+  }
+  for (at = 0; at < count; at++) {
+    lvm_gc_barrier(this, (gc_p)frame->env,
+        (gc_p)this->values.data[base + at]);
+    frame->env->data[(at << 1) + 1] = this->values.data[base + at];
+  }
+  values_pop(this, base);
+  roots_set(this, frame->root + 1, (gc_p)frame->env);
+}
+
+/* closures made by earlier iterations keep their own loop frame */
+void op_recur_fresh(lvm_p this, frame_p frame, instr_p instr)
+{
+  size_t depth = instr->operand >> LOCAL_BITS;
+  size_t count = instr->operand & LOCAL_MASK;
+  size_t base = this->values.count - count;
+  env_p env = frame->env;
+  size_t at;
+  for (; depth; depth--) {
+    env = env->outer;
+  }
+  frame->env = env_make(this, env->outer, NULL, 0, NULL, NULL,
+      env->count);
+  frame->env->shadow = env->shadow;
+  for (at = 0; at < count; at++) {
+    env_set(this, frame->env, env->data[at << 1],
+        this->values.data[base + at]);
+  }
+  for (at = count << 1; at < env->count; at += 2) {
+    env_set(this, frame->env, env->data[at], env->data[at + 1]);
+  }
+  values_pop(this, base);
+  roots_set(this, frame->root + 1, (gc_p)frame->env);
+}
+
+mal_p op_invoke(lvm_p this, frame_p frame, instr_p instr, bool tail)
+{
+  size_t argc = instr->operand;
+  size_t at;
+  mal_p callable;
+  mal_p value;
+  closure_p closure;
+  lambda_p lambda;
+  list_p parameters;
+  env_p env;
+  if (this->gc.count >= this->gc.total) {
+    lvm_gc(this);
+  }
+  at = this->values.count - argc - 1;
+  callable = this->values.data[at];
+  switch (callable->type) {
+  case MAL_SYMBOL:
+    values_pop(this, at);
+    return instr->constant;
+  case MAL_CLOSURE:
+    break;
+  default:
+    value = eval_apply(this, callable, argc, this->values.data + at + 1,
+        frame->env);
+    values_pop(this, at);
+    return value;
+  }
+  closure = callable->as.closure;
+  lambda = closure->lambda;
+  parameters = lambda->parameters->as.list;
+  if (parameters->count > argc) {
+    values_pop(this, at);
+    return mal_error(this, ERROR_RUNTIME,
+        text_concat(this, text_concat_text(this, text_make(this,
+        "'fn*': too few arguments supplied to the function '"),
+        text_make_integer(this, argc)), "'\n"));
+  } else if (parameters->count < argc && is_nil(lambda->more)) {
+    values_pop(this, at);
+    return mal_error(this, ERROR_RUNTIME,
+        text_concat(this, text_concat_text(this, text_make(this,
+        "'fn*': too many arguments supplied to the function '"),
+        text_make_integer(this, argc)), "'\n"));
+  }
+  if (NULL == lambda->code) {
+    lambda->code = compile(this, lambda->definition);
+    lvm_gc_barrier(this, (gc_p)lambda, (gc_p)lambda->code);
+  }
+  if (tail) {
+    env_pop(this, frame->envs);
+  } else if (frames_push(this, frame)) {
+    frame->envs = this->envs.count;
+  } else {
+    values_pop(this, at);
+    return mal_error(this, ERROR_RUNTIME, text_concat(this,
+        text_concat_text(this, text_make(this,
+        "'fn*': call depth limit reached '"),
+        text_make_integer(this, this->frames.max)), "'\n"));
+  }
+  env = lambda->code->stack ?
+      env_push(this, closure->env, parameters, argc,
+      this->values.data + at + 1, lambda->more,
+      (parameters->count + 1) << 1) :
+      env_make(this, closure->env, parameters, argc,
+      this->values.data + at + 1, lambda->more,
+      (parameters->count + 1) << 1);
+  values_pop(this, at);
+  if (!tail) {
+    frame->base = this->values.count;
+  }
+  frame->code = lambda->code;
+  frame->env = env;
+  frame->ip = 0;
+  frame->version = 0;
+  roots_set(this, frame->root, (gc_p)frame->code);
+  roots_set(this, frame->root + 1, (gc_p)frame->env);
+  return NULL;
+}
+
+void op_call(lvm_p this, frame_p frame, instr_p instr)
+{
+  mal_p value = op_invoke(this, frame, instr, false);
+  if (NULL != value) {
+    op_push(this, frame, value);
+  }
+}
+
+void op_tail_call(lvm_p this, frame_p frame, instr_p instr)
+{
+  mal_p value = op_invoke(this, frame, instr, true);
+  if (NULL != value) {
+    op_push(this, frame, value);
+    if (NULL == frame->result) {
+      op_return(this, frame, instr);
+    }
+  }
+}
+
 char *lvm_print(lvm_p this, mal_p value)
 {
   char *output;
@@ -5078,7 +8498,7 @@ int main(int argc, char *argv[])
   size_t at;
   typedef struct core_s {
     char *symbol;
-    mal_p (*function)(lvm_p this, mal_p params);
+    mal_p (*function)(lvm_p this, size_t argc, mal_pp argv);
   } core_t;
   core_t core[] = {
     {"+", core_add},
@@ -5100,6 +8520,9 @@ int main(int argc, char *argv[])
     {"env?", core_envp},
     {"empty?", core_emptyp},
     {"count", core_count},
+    {"assoc", core_assoc},
+    {"dissoc", core_dissoc},
+    {"pop", core_pop},
     {"pr-str", core_pr_str},
     {"str", core_str},
     {"prn", core_prn},
@@ -5115,7 +8538,8 @@ int main(int argc, char *argv[])
   for (at = 0; core[at].symbol; at++) {
     key = mal_symbol(lvm, text_make(lvm, core[at].symbol));
     value = mal_function(lvm, function_make(lvm, core[at].function,
-        key->identity));
+        key->as.symbol));
+    lvm_immortal(lvm, (gc_p)value);
     env_set(lvm, lvm->env, key, value);
   }
   lvm_eval(lvm, lvm_read(lvm, "(def! not (fn* (a) (if a false true)))"),